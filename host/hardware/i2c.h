@@ -0,0 +1,37 @@
+/*!
+	@file i2c.h
+	@brief OLED driven by SSD1306 controller. header file
+		standing in for the pico-sdk hardware_i2c on host builds.
+	@details The host platform of the pico-sdk has no I2C. This declares the
+		part of hardware_i2c the library uses, ssd1306_oled_emu.cpp
+		implements it on the emulated buses.
+*/
+
+#pragma once
+
+#include "pico/stdlib.h"
+
+/*! @brief I2C instance , index 0 or 1 */
+typedef struct i2c_inst
+{
+	uint8_t index;        /**< Controller number */
+	bool restart_on_next; /**< Kept for source compatibility with the pico-sdk */
+} i2c_inst_t;
+
+extern i2c_inst_t i2c0_inst; /**< First emulated controller */
+extern i2c_inst_t i2c1_inst; /**< Second emulated controller */
+
+#define i2c0 (&i2c0_inst) /**< Same names as the pico-sdk */
+#define i2c1 (&i2c1_inst) /**< Same names as the pico-sdk */
+
+unsigned int i2c_init(i2c_inst_t *i2c, unsigned int baudrate);
+void i2c_deinit(i2c_inst_t *i2c);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop);
+
+/*!
+	@brief Gets the controller number
+	@param i2c i2c0 or i2c1
+	@return 0 or 1
+*/
+static inline unsigned int i2c_hw_index(i2c_inst_t *i2c) {return i2c->index;}
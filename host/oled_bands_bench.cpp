@@ -0,0 +1,109 @@
+/*!
+	@file oled_bands_bench.cpp
+	@brief OLED driven by SSD1306 controller. Host benchmark
+		of the banded two core renderer.
+	@details Renders a busy dashboard from a display list on one thread and
+		then with the band worker started, and prints the time per frame of
+		both. Fails if the two frames differ. On a host with one CPU the
+		two threads can not run at the same time, compare the band times.
+*/
+
+#include "ssd1306_oled_bands.h"
+#include <stdlib.h>
+
+#define BENCH_OPS 512     /**< Display list capacity */
+#define BENCH_FRAMES 500  /**< Frames timed per mode */
+
+static OLEDDrawOp_t ops[BENCH_OPS];
+static char labels[8][12]; /**< Text ops keep a pointer to their string */
+
+/*!
+	@brief Records the dashboard , a chart, gauges, bars and labels
+	@param list display list to fill
+	@param gfx graphics object the text state is taken from
+*/
+static void recordDashboard(OLEDDisplayList &list, SSD1306_graphics &gfx)
+{
+	list.clear();
+	for (int16_t x = 0; x < 128; x += 8) list.drawLine(x, 0, x, 63, WHITE); // grid
+	for (int16_t y = 0; y < 64; y += 8) list.drawLine(0, y, 127, y, WHITE);
+	int16_t last = 32;
+	for (int16_t x = 1; x < 128; x++) // chart
+	{
+		int16_t value = 8 + rand() % 48;
+		list.drawLine(x - 1, last, x, value, INVERSE);
+		last = value;
+	}
+	for (uint8_t g = 0; g < 8; g++) // gauges
+	{
+		int16_t cx = 8 + (g % 4) * 32, cy = 16 + (g / 4) * 32;
+		list.drawCircle(cx, cy, 12, WHITE);
+		list.fillCircle(cx, cy, 3 + rand() % 8, INVERSE);
+		list.drawRoundRect(cx - 14, cy - 14, 28, 28, 5, WHITE);
+		list.fillTriangle(cx, cy - 10, cx - 6, cy + 4, cx + 6, cy + 4, INVERSE);
+	}
+	for (uint8_t b = 0; b < 32; b++) // bars
+	{
+		int16_t h = rand() % 60;
+		list.fillRect(b * 4, 63 - h, 3, h, INVERSE);
+	}
+	for (uint8_t row = 0; row < 8; row++) // labels
+	{
+		snprintf(labels[row], sizeof(labels[row]), "CH%u %4d", row, rand() % 10000);
+		list.drawText(gfx, (row % 2) * 64, row * 8, labels[row], WHITE, BLACK);
+	}
+}
+
+/*!
+	@brief Renders the list repeatedly and times it
+	@param renderer band renderer
+	@param list display list
+	@param pBuffer frame buffer of the display
+	@return mean time per frame in microseconds
+*/
+static double timeFrames(OLEDBandRenderer &renderer, const OLEDDisplayList &list, uint8_t *pBuffer)
+{
+	uint64_t start = time_us_64();
+	for (uint16_t frame = 0; frame < BENCH_FRAMES; frame++)
+	{
+		memset(pBuffer, 0x00, 128 * (64 / 8));
+		renderer.render(list);
+	}
+	return (double)(time_us_64() - start) / BENCH_FRAMES;
+}
+
+int main(void)
+{
+	static uint8_t buffer[128 * (64 / 8)];
+	static uint8_t single[128 * (64 / 8)];
+	SSD1306 oled(128, 64);
+	oled.OLEDSetBufferPtr(128, 64, buffer, sizeof(buffer));
+	oled.setFontNum(OLEDFont_Default);
+
+	OLEDDisplayList list;
+	list.begin(ops, BENCH_OPS);
+	srand(1);
+	recordDashboard(list, oled);
+	OLEDBandRenderer renderer(oled, 128, 64);
+
+	double oneUs = timeFrames(renderer, list, buffer);
+	uint32_t oneBand0 = renderer.bandTimeUs(0), oneBand1 = renderer.bandTimeUs(1);
+	memcpy(single, buffer, sizeof(single));
+
+	renderer.start();
+	double twoUs = timeFrames(renderer, list, buffer);
+	uint32_t twoBand0 = renderer.bandTimeUs(0), twoBand1 = renderer.bandTimeUs(1);
+	renderer.stop();
+
+	printf("dashboard %u ops, %u frames\n", list.size(), BENCH_FRAMES);
+	printf("one thread  %8.1f us/frame  band0 %lu us band1 %lu us\n", oneUs,
+		(unsigned long)oneBand0, (unsigned long)oneBand1);
+	printf("two threads %8.1f us/frame  band0 %lu us band1 %lu us  speedup %.2f\n", twoUs,
+		(unsigned long)twoBand0, (unsigned long)twoBand1, oneUs / twoUs);
+	if (memcmp(single, buffer, sizeof(buffer)) != 0 || list.overflowed())
+	{
+		printf("bands bench FAILED , frames differ\n");
+		return 1;
+	}
+	return 0;
+}
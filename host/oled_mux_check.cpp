@@ -0,0 +1,126 @@
+/*!
+	@file oled_mux_check.cpp
+	@brief OLED driven by SSD1306 controller. Host check
+		of the bus scheduler with displays behind a multiplexer.
+	@details Four 128x64 panels with the same address sit on channels 0-3 of
+		a TCA9548A on i2c0 of the emulator. Frames are sent through
+		OLEDBusScheduler. The check fails if a panel does not show its
+		buffer, or if a frame needs more channel switches than one per
+		display plus one per OLED_BUS_MUX_HOLD chunks.
+*/
+
+#include "ssd1306_oled_bus.h"
+#include "ssd1306_oled_mux.h"
+#include "ssd1306_oled_emu.h"
+#include <stdlib.h>
+
+#define CHECK_DISPLAYS 4  /**< Displays behind the multiplexer */
+#define CHECK_FRAMES 20   /**< Frames per scenario */
+
+static SSD1306 *displays[CHECK_DISPLAYS];
+static OLEDEmuPanel *panels[CHECK_DISPLAYS];
+static uint8_t buffers[CHECK_DISPLAYS][128 * (64 / 8)];
+static uint8_t failures = 0;
+
+/*!
+	@brief Compares every panel with its buffer
+	@param pName scenario name for the report
+*/
+static void checkPanels(const char *pName)
+{
+	for (uint8_t i = 0; i < CHECK_DISPLAYS; i++)
+	{
+		uint32_t differ = panels[i]->compare(buffers[i], 128, 64);
+		if (differ == 0) continue;
+		printf("FAIL %s: channel %u has %lu wrong bytes\n", pName, i, (unsigned long)differ);
+		failures++;
+	}
+}
+
+/*!
+	@brief Sends frames and checks the switches per frame
+	@param scheduler scheduler of the displays
+	@param pName scenario name for the report
+	@param dirty true draw small areas and send them with OLEDupdateDirty
+*/
+static void runFrames(OLEDBusScheduler &scheduler, const char *pName, bool dirty)
+{
+	OLEDEmuBus &bus = OLEDEmu::bus(i2c0);
+	uint32_t worst = 0;
+	uint32_t chunks = 0;
+	uint32_t switches = 0;
+	for (uint16_t frame = 0; frame < CHECK_FRAMES; frame++)
+	{
+		for (uint8_t i = 0; i < CHECK_DISPLAYS; i++)
+		{
+			if (dirty)
+			{
+				int16_t x = rand() % 120, y = rand() % 56;
+				displays[i]->fillRect(x, y, 8, 8, INVERSE);
+				displays[i]->markDirty(x, y, 8, 8);
+			}
+			else
+			{
+				for (uint16_t k = 0; k < sizeof(buffers[i]); k++) buffers[i][k] = rand();
+			}
+		}
+		bus.resetStats();
+		for (uint8_t i = 0; i < CHECK_DISPLAYS; i++)
+		{
+			if (dirty) displays[i]->OLEDupdateDirty();
+			else displays[i]->OLEDupdate();
+		}
+		scheduler.waitIdle();
+		OLEDEmuStats_t stats = bus.stats();
+		uint32_t frameChunks = stats.transactions - stats.muxWrites;
+		uint32_t budget = CHECK_DISPLAYS + frameChunks / OLED_BUS_MUX_HOLD;
+		if (stats.muxWrites > worst) worst = stats.muxWrites;
+		if (stats.muxWrites > budget)
+		{
+			printf("FAIL %s: frame %u took %lu switches for %lu chunks\n", pName, frame,
+				(unsigned long)stats.muxWrites, (unsigned long)frameChunks);
+			failures++;
+		}
+		chunks += frameChunks;
+		switches += stats.muxWrites;
+	}
+	checkPanels(pName);
+	printf("%-6s %5.1f chunks/frame %5.2f switches/frame worst %lu\n", pName,
+		(double)chunks / CHECK_FRAMES, (double)switches / CHECK_FRAMES, (unsigned long)worst);
+}
+
+int main(void)
+{
+	i2c_init(i2c0, 400000);
+	OLEDEmuBus &bus = OLEDEmu::bus(i2c0);
+	bus.setMux(OLED_MUX_ADDR);
+	OLEDI2CMux mux(i2c0);
+	for (uint8_t i = 0; i < CHECK_DISPLAYS; i++)
+	{
+		panels[i] = bus.addPanel(SSD1306_ADDR, i);
+		displays[i] = new SSD1306(128, 64);
+		displays[i]->OLEDSetMux(&mux, i);
+		displays[i]->OLEDbegin(i2c0, SSD1306_ADDR);
+		displays[i]->OLEDSetBufferPtr(128, 64, buffers[i], sizeof(buffers[i]));
+	}
+
+	OLEDBusScheduler scheduler;
+	for (uint8_t i = 0; i < CHECK_DISPLAYS; i++)
+		scheduler.addDisplay(*displays[i]);
+
+	srand(1);
+	runFrames(scheduler, "full", false);
+	runFrames(scheduler, "dirty", true);
+
+	// a blocking command to one display between the chunks of another
+	for (uint16_t k = 0; k < sizeof(buffers[0]); k++) buffers[0][k] = rand();
+	displays[0]->OLEDupdate();
+	scheduler.service();
+	displays[1]->OLEDContrast(0x10);
+	scheduler.waitIdle();
+	checkPanels("command");
+
+	scheduler.end();
+	printf("%s\n", failures ? "mux check FAILED" : "mux check passed");
+	return failures ? 1 : 0;
+}
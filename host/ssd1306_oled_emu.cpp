@@ -0,0 +1,389 @@
+/*!
+	@file ssd1306_oled_emu.cpp
+	@brief OLED driven by SSD1306 controller. Source file
+		for the host emulator of the I2C buses.
+*/
+
+#include "ssd1306_oled_emu.h"
+
+i2c_inst_t i2c0_inst = {0, false};
+i2c_inst_t i2c1_inst = {1, false};
+
+OLEDEmuBus OLEDEmu::_buses[2];
+
+// ******** pico-sdk hardware_i2c on the emulated buses ********
+
+/*!
+	@brief Sets the baud rate of an emulated bus
+	@param i2c i2c0 or i2c1
+	@param baudrate bus clock in Hz , used for the time estimate
+	@return baudrate
+*/
+unsigned int i2c_init(i2c_inst_t *i2c, unsigned int baudrate)
+{
+	OLEDEmu::bus(i2c).setBaudrate(baudrate);
+	return baudrate;
+}
+
+/*! @brief Does nothing on the emulated bus @param i2c i2c0 or i2c1 */
+void i2c_deinit(i2c_inst_t *i2c) {(void)i2c;}
+
+/*!
+	@brief Sends one write transaction on an emulated bus
+	@param i2c i2c0 or i2c1
+	@param addr 7 bit address
+	@param src bytes after the address
+	@param len number of bytes
+	@param nostop ignored , every transaction ends with a STOP
+	@return len , OLED_EMU_NACK if no device has the address
+*/
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop)
+{
+	(void)nostop;
+	return OLEDEmu::bus(i2c).write(addr, src, len);
+}
+
+/*!
+	@brief Reads from an emulated bus , panels return 0x00
+	@param i2c i2c0 or i2c1
+	@param addr 7 bit address
+	@param dst buffer for the bytes
+	@param len number of bytes
+	@param nostop ignored
+	@return len , OLED_EMU_NACK if no device has the address
+*/
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop)
+{
+	(void)nostop;
+	return OLEDEmu::bus(i2c).read(addr, dst, len);
+}
+
+// ******** OLEDEmu ********
+
+/*!
+	@brief Gets an emulated bus
+	@param i2c i2c0 or i2c1
+	@return the bus
+*/
+OLEDEmuBus &OLEDEmu::bus(i2c_inst *i2c)
+{
+	return _buses[i2c_hw_index(i2c) & 0x01];
+}
+
+/*!
+	@brief Removes all devices from both buses
+*/
+void OLEDEmu::clear(void)
+{
+	_buses[0].clear();
+	_buses[1].clear();
+}
+
+// ******** OLEDEmuBus ********
+
+/*!
+	@brief Removes the multiplexer and the panels , resets the counters
+*/
+void OLEDEmuBus::clear(void)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	_count = 0;
+	_muxAddress = -1;
+	_muxMask = 0;
+	_stats = OLEDEmuStats_t{};
+}
+
+/*!
+	@brief Puts a multiplexer on the bus , all its channels closed
+	@param address I2C address , 0x70-0x77
+*/
+void OLEDEmuBus::setMux(uint8_t address)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	_muxAddress = address;
+	_muxMask = 0;
+}
+
+/*!
+	@brief Puts a panel on the bus
+	@param address I2C address of the panel
+	@param channel multiplexer channel 0-7 , OLED_EMU_DIRECT if on the bus itself
+	@return the panel , nullptr if OLED_EMU_PANELS are on the bus already
+*/
+OLEDEmuPanel *OLEDEmuBus::addPanel(uint8_t address, uint8_t channel)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	if (_count >= OLED_EMU_PANELS) return nullptr;
+	OLEDEmuSlot_t &slot = _slots[_count++];
+	slot.panel.reset();
+	slot.address = address;
+	slot.channel = channel;
+	return &slot.panel;
+}
+
+/*!
+	@brief Sets the bus clock used for the time estimate
+	@param baudrate clock in Hz
+*/
+void OLEDEmuBus::setBaudrate(uint32_t baudrate)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	if (baudrate > 0) _baudrate = baudrate;
+}
+
+/*!
+	@brief Runs one write transaction
+	@param address 7 bit address
+	@param pData bytes after the address
+	@param length number of bytes
+	@return length , OLED_EMU_NACK if no device has the address
+	@details A one byte write to the multiplexer sets its open channels.
+		Several panels with the same address on open channels all take the
+		write, as on real hardware.
+*/
+int OLEDEmuBus::write(uint8_t address, const uint8_t *pData, size_t length)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	count(length);
+	if (address == _muxAddress)
+	{
+		if (length > 0) _muxMask = pData[length - 1];
+		_stats.muxWrites++;
+		return (int)length;
+	}
+	bool acked = false;
+	for (uint8_t i = 0; i < _count; i++)
+	{
+		if (!reaches(_slots[i], address)) continue;
+		_slots[i].panel.write(pData, length);
+		acked = true;
+	}
+	if (acked) return (int)length;
+	_stats.nacks++;
+	return OLED_EMU_NACK;
+}
+
+/*!
+	@brief Runs one read transaction
+	@param address 7 bit address
+	@param pData buffer for the bytes
+	@param length number of bytes
+	@return length , OLED_EMU_NACK if no device has the address
+*/
+int OLEDEmuBus::read(uint8_t address, uint8_t *pData, size_t length)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	count(length);
+	bool acked = (address == _muxAddress);
+	for (uint8_t i = 0; i < _count && !acked; i++)
+		acked = reaches(_slots[i], address);
+	if (!acked)
+	{
+		_stats.nacks++;
+		return OLED_EMU_NACK;
+	}
+	if (address == _muxAddress)
+	{
+		for (size_t i = 0; i < length; i++) pData[i] = _muxMask;
+	}
+	else
+		memset(pData, 0x00, length);
+	return (int)length;
+}
+
+/*!
+	@brief Gets the counters
+	@return copy of the counters
+*/
+OLEDEmuStats_t OLEDEmuBus::stats(void) const
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	return _stats;
+}
+
+/*!
+	@brief Sets all counters to 0
+*/
+void OLEDEmuBus::resetStats(void)
+{
+	std::lock_guard<std::mutex> guard(_lock);
+	_stats = OLEDEmuStats_t{};
+}
+
+/*!
+	@brief Checks if a transaction reaches a panel , used internally
+	@param slot panel
+	@param address address of the transaction
+	@return true if the address matches and the channel of the panel is open
+*/
+bool OLEDEmuBus::reaches(const OLEDEmuSlot_t &slot, uint8_t address) const
+{
+	if (slot.address != address) return false;
+	if (slot.channel == OLED_EMU_DIRECT) return true;
+	return (_muxMask & (1 << (slot.channel & 0x07))) != 0;
+}
+
+/*!
+	@brief Counts a transaction , used internally
+	@param length bytes after the address
+	@details Each byte takes 9 clocks with its acknowledge, START, address and
+		STOP are counted as one more byte.
+*/
+void OLEDEmuBus::count(size_t length)
+{
+	_stats.transactions++;
+	_stats.bytes += length;
+	_stats.busTimeUs += ((uint64_t)(length + 1) * 9 * 1000000 + _baudrate - 1) / _baudrate;
+}
+
+// ******** OLEDEmuPanel ********
+
+/*!
+	@brief Clears display RAM and the addressing state , as at power on
+*/
+void OLEDEmuPanel::reset(void)
+{
+	memset(_ram, 0x00, sizeof(_ram));
+	_mode = 2;
+	_column0 = 0;
+	_column1 = OLED_EMU_WIDTH - 1;
+	_page0 = 0;
+	_page1 = OLED_EMU_PAGES - 1;
+	_column = 0;
+	_page = 0;
+	_need = 0;
+	_got = 0;
+	_dataBytes = 0;
+}
+
+/*!
+	@brief Takes one write transaction addressed to the panel
+	@param pData control byte then command or data bytes
+	@param length number of bytes
+	@note The D/C bit of the first control byte decides for the whole
+		transaction , the Co bit is not modelled.
+*/
+void OLEDEmuPanel::write(const uint8_t *pData, size_t length)
+{
+	if (length == 0) return;
+	bool isData = (pData[0] & 0x40) != 0;
+	for (size_t i = 1; i < length; i++)
+	{
+		if (isData)
+			data(pData[i]);
+		else
+			command(pData[i]);
+	}
+}
+
+/*!
+	@brief Gets one byte of display RAM
+	@param page 0-7
+	@param column 0-127
+	@return the byte , bit 0 is the top row of the page
+*/
+uint8_t OLEDEmuPanel::ram(uint8_t page, uint8_t column) const
+{
+	return _ram[page % OLED_EMU_PAGES][column % OLED_EMU_WIDTH];
+}
+
+/*!
+	@brief Compares display RAM with a frame buffer
+	@param pBuffer buffer of width * (height/8) bytes , page by page
+	@param width width of buffer in pixels
+	@param height height of buffer in pixels
+	@return number of bytes that differ , 0 when the panel shows the buffer
+*/
+uint32_t OLEDEmuPanel::compare(const uint8_t *pBuffer, uint8_t width, uint8_t height) const
+{
+	uint32_t differ = 0;
+	for (uint8_t page = 0; page < (height / 8) && page < OLED_EMU_PAGES; page++)
+		for (uint8_t x = 0; x < width && x < OLED_EMU_WIDTH; x++)
+			if (_ram[page][x] != pBuffer[page * width + x]) differ++;
+	return differ;
+}
+
+/*!
+	@brief Gets the number of display RAM bytes written
+	@return count since reset
+*/
+uint32_t OLEDEmuPanel::dataBytes(void) const {return _dataBytes;}
+
+/*!
+	@brief Decodes one command byte , used internally
+	@param byte command or parameter byte
+*/
+void OLEDEmuPanel::command(uint8_t byte)
+{
+	if (_need > 0)
+	{
+		_params[_got++] = byte;
+		if (--_need > 0) return;
+		switch (_opcode)
+		{
+			case 0x20: _mode = _params[0] & 0x03; break;
+			case 0x21:
+				_column0 = _params[0] & 0x7F;
+				_column1 = _params[1] & 0x7F;
+				_column = _column0;
+			break;
+			case 0x22:
+				_page0 = _params[0] & 0x07;
+				_page1 = _params[1] & 0x07;
+				_page = _page0;
+			break;
+			default: break;
+		}
+		return;
+	}
+	_opcode = byte;
+	_got = 0;
+	switch (byte)
+	{
+		case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+		case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+			_need = 1;
+		break;
+		case 0x21: case 0x22: case 0xA3:
+			_need = 2;
+		break;
+		case 0x29: case 0x2A:
+			_need = 5;
+		break;
+		case 0x26: case 0x27:
+			_need = 6;
+		break;
+		default:
+			if (_mode != 2) break;
+			if (byte <= 0x0F) _column = (_column & 0xF0) | byte;
+			else if (byte <= 0x1F) _column = (_column & 0x0F) | ((byte & 0x07) << 4);
+			else if (byte >= 0xB0 && byte <= 0xB7) _page = byte & 0x07;
+		break;
+	}
+}
+
+/*!
+	@brief Writes one byte to display RAM and moves the pointer , used internally
+	@param byte data byte
+*/
+void OLEDEmuPanel::data(uint8_t byte)
+{
+	_ram[_page][_column] = byte;
+	_dataBytes++;
+	switch (_mode)
+	{
+		case 0: // horizontal
+			if (_column < _column1) {_column++; break;}
+			_column = _column0;
+			_page = (_page < _page1) ? _page + 1 : _page0;
+		break;
+		case 1: // vertical
+			if (_page < _page1) {_page++; break;}
+			_page = _page0;
+			_column = (_column < _column1) ? _column + 1 : _column0;
+		break;
+		default: // page
+			_column = (_column + 1) & 0x7F;
+		break;
+	}
+}
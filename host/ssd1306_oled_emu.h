@@ -0,0 +1,126 @@
+/*!
+	@file ssd1306_oled_emu.h
+	@brief OLED driven by SSD1306 controller. header file
+		for the host emulator of the I2C buses.
+	@details Models i2c0 and i2c1 with SSD1306 panels and TCA9548A style
+		multiplexers on them, so configurations with many displays can be
+		checked and measured without hardware. Each write transaction goes
+		to the device at its address, panels behind a multiplexer only see
+		it while their channel is open. Panels keep their display RAM, so a
+		check compares it with the frame buffer that was sent.
+*/
+
+#pragma once
+
+#include "hardware/i2c.h"
+#include <mutex>
+
+#ifndef OLED_EMU_PANELS
+#define OLED_EMU_PANELS 8 /**< Panels on one emulated bus */
+#endif
+#define OLED_EMU_NACK -2          /**< Write not acknowledged , PICO_ERROR_GENERIC */
+#define OLED_EMU_DIRECT 0xFF      /**< Panel channel for a panel not behind the multiplexer */
+#define OLED_EMU_WIDTH 128        /**< Columns of panel display RAM */
+#define OLED_EMU_PAGES 8          /**< Pages of panel display RAM */
+
+/*!
+	@brief class for the display RAM and command decoder of one SSD1306
+	@note Decodes the addressing commands the library sends, other commands
+		only have their parameter bytes skipped.
+*/
+class OLEDEmuPanel
+{
+  public:
+	OLEDEmuPanel(){};
+
+	void reset(void);
+	void write(const uint8_t *pData, size_t length);
+	uint8_t ram(uint8_t page, uint8_t column) const;
+	uint32_t compare(const uint8_t *pBuffer, uint8_t width, uint8_t height) const;
+	uint32_t dataBytes(void) const;
+
+  private:
+
+	void command(uint8_t byte);
+	void data(uint8_t byte);
+
+	uint8_t _ram[OLED_EMU_PAGES][OLED_EMU_WIDTH]; /**< Display RAM */
+	uint8_t _mode = 2;        /**< Addressing mode , 0 horizontal 1 vertical 2 page */
+	uint8_t _column0 = 0;     /**< Window first column */
+	uint8_t _column1 = 127;   /**< Window last column */
+	uint8_t _page0 = 0;       /**< Window first page */
+	uint8_t _page1 = 7;       /**< Window last page */
+	uint8_t _column = 0;      /**< Column written next */
+	uint8_t _page = 0;        /**< Page written next */
+	uint8_t _params[6];       /**< Parameter bytes of the command in progress */
+	uint8_t _need = 0;        /**< Parameter bytes still to come */
+	uint8_t _got = 0;         /**< Parameter bytes received */
+	uint8_t _opcode = 0;      /**< Command waiting for parameters */
+	uint32_t _dataBytes = 0;  /**< Display RAM bytes written */
+};
+
+/*! @brief Struct to hold the counters of one emulated bus */
+struct OLEDEmuStats_t
+{
+	uint32_t transactions; /**< Write and read transactions , acknowledged or not */
+	uint32_t bytes;        /**< Bytes after the address byte */
+	uint32_t muxWrites;    /**< Multiplexer control register writes */
+	uint32_t nacks;        /**< Transactions nobody acknowledged */
+	uint64_t busTimeUs;    /**< Time the bus would have been busy at its baud rate */
+};
+
+/*!
+	@brief class for one emulated I2C bus
+	@details Get it with OLEDEmu::bus. Add the multiplexer and the panels
+		before the displays are started. Safe to use from several threads.
+*/
+class OLEDEmuBus
+{
+  public:
+	OLEDEmuBus(){};
+
+	void clear(void);
+	void setMux(uint8_t address);
+	OLEDEmuPanel *addPanel(uint8_t address, uint8_t channel = OLED_EMU_DIRECT);
+	void setBaudrate(uint32_t baudrate);
+
+	int write(uint8_t address, const uint8_t *pData, size_t length);
+	int read(uint8_t address, uint8_t *pData, size_t length);
+
+	OLEDEmuStats_t stats(void) const;
+	void resetStats(void);
+
+  private:
+
+	/*! @brief one panel on the bus */
+	struct OLEDEmuSlot_t
+	{
+		OLEDEmuPanel panel; /**< Display RAM and decoder */
+		uint8_t address;    /**< I2C address */
+		uint8_t channel;    /**< Multiplexer channel , OLED_EMU_DIRECT if none */
+	};
+
+	bool reaches(const OLEDEmuSlot_t &slot, uint8_t address) const;
+	void count(size_t length);
+
+	mutable std::mutex _lock;         /**< Serialises the threads writing */
+	OLEDEmuSlot_t _slots[OLED_EMU_PANELS]; /**< Panels */
+	uint8_t _count = 0;               /**< Panels added */
+	int16_t _muxAddress = -1;         /**< Multiplexer address , -1 none */
+	uint8_t _muxMask = 0;             /**< Open multiplexer channels */
+	uint32_t _baudrate = 400000;      /**< Bus clock for the time estimate */
+	OLEDEmuStats_t _stats{};          /**< Counters */
+};
+
+/*!
+	@brief class giving access to the two emulated buses
+*/
+class OLEDEmu
+{
+  public:
+	static OLEDEmuBus &bus(i2c_inst *i2c);
+	static void clear(void);
+
+  private:
+	static OLEDEmuBus _buses[2]; /**< i2c0 and i2c1 */
+};
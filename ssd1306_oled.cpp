@@ -8,6 +8,23 @@
 */
 
 #include "ssd1306_oled.h"
+#include "ssd1306_oled_mux.h"
+
+/*!
+	@brief Applies a pixel color to the masked bits of one buffer byte
+	@param byte buffer byte to modify
+	@param color WHITE BLACK or INVERSE
+	@param mask bits to change
+*/
+static inline void OLEDApplyColor(uint8_t &byte, uint8_t color, uint8_t mask)
+{
+	switch (color)
+	{
+		case WHITE:  byte |= mask; break;
+		case BLACK:  byte &= ~mask; break;
+		case INVERSE: byte ^= mask; break;
+	}
+}
 
 /*!
 	@brief init the screen object
@@ -21,6 +38,9 @@ SSD1306::SSD1306(int16_t oledwidth, int16_t oledheight) :SSD1306_graphics(oledwi
 	_OLED_PAGE_NUM = (_OLED_HEIGHT/8); 
 	bufferWidth = _OLED_WIDTH;
 	bufferHeight = _OLED_HEIGHT;
+	OLEDClearDirty();
+	memset(_txDirtyX0, 0xFF, sizeof(_txDirtyX0));
+	memset(_txDirtyX1, 0x00, sizeof(_txDirtyX1));
 }
 
 /*!
@@ -51,18 +71,27 @@ bool SSD1306::OLEDSetBufferPtr(uint8_t width, uint8_t height , uint8_t* pBuffer,
 {
 	if(sizeOfBuffer !=  width * (height/8))
 	{
-		printf("Error OLEDSetBufferPtr 1: buffer size does not equal : width * (height/8))\n");
+		OLED_ERROR(OLED_BufferSize, "OLEDSetBufferPtr 1", "buffer size does not equal : width * (height/8))\n");
 		return false;
 	}
 	OLEDbuffer = pBuffer;
 	if(OLEDbuffer ==  nullptr)
 	{
-		printf("Error OLEDSetBufferPtr 2: Problem assigning buffer pointer, not a valid pointer object\r\n");
+		OLED_ERROR(OLED_BufferNullptr, "OLEDSetBufferPtr 2", "Problem assigning buffer pointer, not a valid pointer object\r\n");
 		return false;
 	}
 	return true;
 }
 
+/*!
+	@brief gets the buffer pointer drawing goes to
+	@return pointer to the buffer, nullptr if none set
+*/
+uint8_t* SSD1306::OLEDGetBufferPtr(void) const
+{
+	return OLEDbuffer;
+}
+
 /*! 
 	@brief Disables  OLED Call when powering down
 */
@@ -84,6 +113,7 @@ void SSD1306::OLEDinit()
 	SSD1306_command(SSD1306_SET_DISPLAY_OFFSET );
 	SSD1306_command(0x00);
 	SSD1306_command(SSD1306_SET_START_LINE);
+	_flipBank = 0;
 	SSD1306_command(SSD1306_CHARGE_PUMP );
 	SSD1306_command(0x14);
 	SSD1306_command(SSD1306_MEMORY_ADDR_MODE );
@@ -114,7 +144,7 @@ switch (_OLED_HEIGHT)
 }
 
 	SSD1306_command( SSD1306_SET_PRECHARGE_PERIOD );
-	SSD1306_command( 0xF1 );
+	SSD1306_command( SSD1306_PRECHARGE_INIT );
 	SSD1306_command( SSD1306_SET_VCOM_DESELECT );
 	SSD1306_command( 0x40 );
 	SSD1306_command( SSD1306_DISPLAY_ALL_ON_RESUME );
@@ -207,26 +237,26 @@ OLED_Return_Codes_e  SSD1306::OLEDBitmap(int16_t x, int16_t y, int16_t w, int16_
 	// 1. Completely out of bounds?
 	if (x > _width || y > _height)
 	{
-		printf("Error drawBitmap 1: Bitmap co-ord out of bounds, check x and y\r\n");
+		OLED_ERROR(OLED_BitmapScreenBounds, "drawBitmap 1", "Bitmap co-ord out of bounds, check x and y\r\n");
 		return OLED_BitmapScreenBounds ;
 	}
 	// 2. bitmap weight and height
 	if (w > _width || h > _height)
 	{
-		printf("Error drawBitmap 2: Bitmap is larger than screen, check w and h\r\n");
+		OLED_ERROR(OLED_BitmapLargerThanScreen, "drawBitmap 2", "Bitmap is larger than screen, check w and h\r\n");
 		return OLED_BitmapLargerThanScreen;
 	}
 	// 3. bitmap is null
 	if(data== nullptr)
 	{
-		printf("Error drawBitmap 3: Bitmap is is not valid pointer\r\n");
+		OLED_ERROR(OLED_BitmapNullptr, "drawBitmap 3", "Bitmap is is not valid pointer\r\n");
 		return OLED_BitmapNullptr;
 	}
 
 	// 4.check bitmap width size
 	if(w % 8 != 0)
 	{
-		printf("Error drawBitmap 4: Bitmap width size is incorrect must be divisible evenly by 8: %u\r\n", w);
+		OLED_ERROR(OLED_BitmapHorizontalSize, "drawBitmap 4", "Bitmap width size is incorrect must be divisible evenly by 8: %u\r\n", w);
 		return OLED_BitmapHorizontalSize;
 	}
 
@@ -266,17 +296,821 @@ OLED_Return_Codes_e  SSD1306::OLEDBitmap(int16_t x, int16_t y, int16_t w, int16_
 void SSD1306::I2C_Write_Byte(unsigned char value, unsigned char cmd)
 {
 	uint8_t buffer[2] = { cmd, value };
+	OLEDWaitIdle();
+	busWait();
+	OLEDMuxSelect();
 	i2c_write_blocking(this->i2CInst, this->address, buffer, 2, false); 
 }
 
+/*!
+	@brief Writes a run of command bytes in a single I2C transaction, used internally
+	@param cmds command bytes
+	@param length number of bytes, max 16
+*/
+void SSD1306::I2C_Write_Commands(const uint8_t* cmds, uint8_t length)
+{
+	uint8_t buffer[17];
+	if (length > 16) length = 16;
+	buffer[0] = SSD1306_COMMAND;
+	memcpy(&buffer[1], cmds, length);
+	OLEDWaitIdle();
+	busWait();
+	OLEDMuxSelect();
+	i2c_write_blocking(this->i2CInst, this->address, buffer, length + 1, false);
+}
+
+/*!
+	@brief Sets the display RAM start line, scrolls the picture vertically
+	@param line start line 0-63
+	@note GDDRAM has 64 rows on all panels, the picture wraps around.
+*/
+void SSD1306::OLEDSetStartLine(uint8_t line)
+{
+	SSD1306_command(SSD1306_SET_START_LINE | (line & 0x3F));
+}
+
+/*!
+	@brief Sets the display RAM window for following OLEDWriteData calls
+	@param x0 first column 0-127
+	@param x1 last column 0-127
+	@param page0 first page 0-7
+	@param page1 last page 0-7
+	@note Pages outside the visible panel height are valid display RAM.
+*/
+void SSD1306::OLEDSetWindow(uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1)
+{
+	const uint8_t cmds[6] = {
+		SSD1306_SET_COLUMN_ADDR, x0, x1,
+		SSD1306_SET_PAGE_ADDR, page0, page1
+	};
+	I2C_Write_Commands(cmds, sizeof(cmds));
+}
+
+/*!
+	@brief Writes display data into the current window
+	@param data page format bytes, column by column
+	@param length number of bytes
+	@note Sent in I2C transactions of up to SSD1306_I2C_CHUNK bytes
+*/
+void SSD1306::OLEDWriteData(const uint8_t* data, uint16_t length)
+{
+	uint8_t buffer[SSD1306_I2C_CHUNK + 1];
+	buffer[0] = SSD1306_DATA_CONTINUE;
+	OLEDWaitIdle();
+	busWait();
+	OLEDMuxSelect();
+	while (length > 0)
+	{
+		uint16_t chunk = (length > SSD1306_I2C_CHUNK) ? SSD1306_I2C_CHUNK : length;
+		memcpy(&buffer[1], data, chunk);
+		i2c_write_blocking(this->i2CInst, this->address, buffer, chunk + 1, false);
+		data += chunk;
+		length -= chunk;
+	}
+}
+
 /*!
 	@brief updates the buffer i.e. writes it to the screen
+	@note When double buffered the front buffer is sent, see OLEDSwapBuffers.
+		When page flipping it is written into the bank shown, see OLEDPresent.
 */
 void SSD1306::OLEDupdate()
 {
-	uint8_t x = 0; uint8_t y = 0; uint8_t w = this->bufferWidth; uint8_t h = this->bufferHeight;
-	//OLEDBufferScreen( x,  y,  w,  h, (uint8_t*) this->OLEDbuffer); TODO
-	OLEDBufferScreen( x,  y,  w,  h, this->OLEDbuffer);
+	sendFrame(_flipBank * (this->bufferHeight / 8));
+}
+
+/*!
+	@brief Turns page flipping on or off for panels lower than 64 pixels
+	@param on true flip between banks of display RAM
+	@return false if the panel uses all display RAM, 64 pixels high
+	@details The controller holds 64 rows on every panel. A 32 pixel high panel
+		shows 32 of them, the rest is free for a second frame, a 16 high panel
+		has room for four. OLEDPresent writes the next frame into a bank that is
+		not shown and then moves the start line to it with one command, so
+		the picture never shows a half written frame.
+	@note The start line is owned by page flipping while on, do not use
+		OLEDSetStartLine or the console at the same time.
+*/
+bool SSD1306::OLEDSetPageFlip(bool on)
+{
+	if (on && this->bufferHeight >= SSD1306_GDDRAM_PAGES * 8)
+	{
+		OLED_ERROR(OLED_TransferState, "OLEDSetPageFlip 1", "No hidden display RAM on a %u pixel high panel\r\n", this->bufferHeight);
+		return false;
+	}
+	OLEDWaitIdle();
+	_pageFlip = on;
+	if (!on && _flipBank != 0)
+	{
+		// show bank 0 again , it holds an older frame until the next update
+		OLEDSetStartLine(0);
+		_flipBank = 0;
+	}
+	return true;
+}
+
+/*!
+	@brief Checks if page flipping is on
+	@return true if frames alternate between banks of display RAM
+*/
+bool SSD1306::OLEDIsPageFlip(void) const {return _pageFlip;}
+
+/*!
+	@brief Shows the buffer, tear free when page flipping is on
+	@details With page flipping the whole frame is written into the next bank
+		of display RAM and the start line is moved to it. Without it, same as
+		OLEDupdate. When double buffered the front buffer is shown.
+*/
+void SSD1306::OLEDPresent(void)
+{
+	if (!_pageFlip)
+	{
+		OLEDupdate();
+		return;
+	}
+	uint8_t pages = this->bufferHeight / 8;
+	uint8_t banks = SSD1306_GDDRAM_PAGES / pages;
+	uint8_t next = (_flipBank + 1) % banks;
+	sendFrame(next * pages);
+	OLEDSetStartLine(next * this->bufferHeight);
+	_flipBank = next;
+}
+
+/*!
+	@brief Sends the whole front buffer , used internally
+	@param firstPage display RAM page the top of the buffer is written to
+*/
+void SSD1306::sendFrame(uint8_t firstPage)
+{
+	OLEDWaitIdle();
+	txBegin(true, firstPage);
+	txRun();
+}
+
+/*!
+	@brief writes only the areas marked with markDirty to the screen
+	@details One window per run of pages with the same changed columns.
+	@note When double buffered the areas handed over by OLEDSwapBuffers are
+		sent from the front buffer, drawing since the swap waits for the next one.
+*/
+void SSD1306::OLEDupdateDirty()
+{
+	OLEDWaitIdle();
+	txBegin(false, _flipBank * (this->bufferHeight / 8));
+	txRun();
+}
+
+/*!
+	@brief Sets a transport sending updates in the background
+	@param pTransport transport , nullptr sends blocking
+	@details OLEDupdate and OLEDupdateDirty then return once the transfer is
+		started. OLEDIsBusy reports it, commands and the next update wait for it.
+	@note Without a second buffer, drawing during the transfer may be sent
+		half done.
+*/
+void SSD1306::OLEDSetTransport(OLEDTxTransport* pTransport)
+{
+	OLEDWaitIdle();
+	_pTransport = pTransport;
+}
+
+/*!
+	@brief Prepares a transfer of the front buffer , used internally
+	@param fullFrame true the whole buffer, false the areas marked dirty
+	@param firstPage display RAM page the top of the buffer is written to
+*/
+void SSD1306::txBegin(bool fullFrame, uint8_t firstPage)
+{
+	if (fullFrame)
+	{
+		if (_txBuffer == nullptr) OLEDClearDirty();
+		memset(_txDirtyX0, 0xFF, sizeof(_txDirtyX0));
+		memset(_txDirtyX1, 0x00, sizeof(_txDirtyX1));
+		for (uint8_t page = 0; page < (this->bufferHeight / 8); page++)
+		{
+			_txDirtyX0[page] = 0;
+			_txDirtyX1[page] = this->bufferWidth - 1;
+		}
+	}
+	else if (_txBuffer == nullptr)
+	{
+		takeDirty();
+	}
+	_txBank = firstPage;
+	_txPage = 0;
+	_txInWindow = false;
+	_txBusy = true;
+}
+
+/*!
+	@brief Sends the prepared transfer , used internally
+	@details Hands it to the transport if one is set, else sends it blocking.
+*/
+void SSD1306::txRun(void)
+{
+	if (_pTransport != nullptr && _pTransport->startTransfer(*this)) return;
+
+	OLEDTxSegment_t segment;
+	while (OLEDTxNextSegment(segment, SSD1306_I2C_CHUNK))
+		txWrite(segment);
+	OLEDTxEnd();
+}
+
+/*!
+	@brief Sends one segment as a blocking I2C transaction , used internally
+	@param segment segment of at most SSD1306_I2C_CHUNK bytes after the control byte
+*/
+void SSD1306::txWrite(const OLEDTxSegment_t &segment)
+{
+	uint8_t buffer[SSD1306_I2C_CHUNK + 1];
+	buffer[0] = segment.control;
+	memcpy(&buffer[1], segment.pData, segment.length);
+	busWait();
+	OLEDMuxSelect();
+	i2c_write_blocking(this->i2CInst, this->address, buffer, segment.length + 1, false);
+}
+
+/*!
+	@brief Starts an update sent in pieces by OLEDupdateStep
+	@param fullFrame true the whole buffer, false the areas marked dirty
+	@note Waits for a transfer in progress first.
+*/
+void SSD1306::OLEDupdateStart(bool fullFrame)
+{
+	OLEDWaitIdle();
+	txBegin(fullFrame, _flipBank * (this->bufferHeight / 8));
+	_txStepped = true;
+}
+
+/*!
+	@brief Sends the next piece of a stepped update and returns
+	@param maxBytes I2C byte budget of this call including control bytes, 0 no limit
+	@param maxMicros time budget of this call, 0 no limit
+	@return true when the update is complete
+	@details Starts an update of the dirty areas if none is in progress. Whole
+		I2C transactions are sent while they fit both budgets, the time per byte
+		is measured as it goes. At least one transaction of up to
+		SSD1306_STEP_MIN_BYTES bytes is sent per call so the update always
+		moves on, that is the worst case for budgets below it.
+	@note Returns false at once while a transport sends in the background.
+		Commands and other updates finish a stepped update first.
+*/
+bool SSD1306::OLEDupdateStep(uint16_t maxBytes, uint32_t maxMicros)
+{
+	if (_txBusy && !_txStepped) return false;
+	if (!_txBusy)
+	{
+		if (!OLEDIsDirty()) return true;
+		OLEDupdateStart(false);
+	}
+
+	const uint64_t start = time_us_64();
+	uint32_t sent = 0;
+	bool first = true;
+	OLEDTxSegment_t segment;
+	while (true)
+	{
+		uint32_t allow = (maxBytes == 0) ? UINT32_MAX : (maxBytes > sent ? maxBytes - sent : 0);
+		if (maxMicros != 0)
+		{
+			uint32_t elapsed = (uint32_t)(time_us_64() - start);
+			uint32_t timeAllow = (elapsed >= maxMicros) ? 0 : ((maxMicros - elapsed) * 16) / _txUsPerByte16;
+			if (timeAllow < allow) allow = timeAllow;
+		}
+		if (allow < SSD1306_STEP_MIN_BYTES)
+		{
+			if (!first) return false;
+			allow = SSD1306_STEP_MIN_BYTES;
+		}
+		uint16_t maxData = (allow - 1 < SSD1306_I2C_CHUNK) ? allow - 1 : SSD1306_I2C_CHUNK;
+		if (!OLEDTxNextSegment(segment, maxData))
+		{
+			_txStepped = false;
+			OLEDTxEnd();
+			return true;
+		}
+		uint64_t before = time_us_64();
+		txWrite(segment);
+		uint32_t perByte16 = (uint32_t)((time_us_64() - before) * 16) / (segment.length + 1);
+		if (perByte16 > UINT16_MAX) perByte16 = UINT16_MAX;
+		if (perByte16 > 0) _txUsPerByte16 = (_txUsPerByte16 * 3 + perByte16) / 4;
+		sent += segment.length + 1;
+		first = false;
+	}
+}
+
+/*!
+	@brief Gets the display data bytes a transfer in progress has still to send
+	@return number of bytes, without control bytes and window commands
+*/
+uint16_t SSD1306::OLEDupdatePending(void) const
+{
+	if (!_txBusy) return 0;
+	uint16_t pending = 0;
+	for (uint8_t page = 0; page < (this->bufferHeight / 8); page++)
+	{
+		if (_txDirtyX0[page] > _txDirtyX1[page]) continue;
+		pending += _txDirtyX1[page] - _txDirtyX0[page] + 1;
+		if (_txInWindow && page == _txPage)
+			pending -= _txCol - _txDirtyX0[page]; // sent part of the page being sent
+	}
+	return pending;
+}
+
+/*!
+	@brief Gets the next I2C transaction of the transfer in progress
+	@param segment filled with the control byte and the bytes following it
+	@param maxData maximum number of bytes after the control byte, at least 6
+	@return false when the transfer has no more segments
+	@details A window command starts each run of pages with the same changed
+		columns, data segments of at most maxData bytes follow, one page at a
+		time. A page counts as sent once its last segment was taken.
+	@note For transports, the data stays in the front buffer, it is not copied.
+*/
+bool SSD1306::OLEDTxNextSegment(OLEDTxSegment_t &segment, uint16_t maxData)
+{
+	if (!_txBusy) return false;
+	uint8_t pages = this->bufferHeight / 8;
+	if (_txInWindow)
+	{
+		if (_txCol > _txDirtyX1[_txPage])
+		{
+			_txDirtyX0[_txPage] = 0xFF;
+			_txDirtyX1[_txPage] = 0x00;
+			_txPage++;
+			if (_txPage <= _txLast) _txCol = _txDirtyX0[_txPage];
+			else _txInWindow = false;
+		}
+		if (_txInWindow)
+		{
+			uint16_t length = _txDirtyX1[_txPage] - _txCol + 1;
+			if (length > maxData) length = maxData;
+			segment.control = SSD1306_DATA_CONTINUE;
+			segment.pData = &frontBuffer()[(bufferWidth * _txPage) + _txCol];
+			segment.length = length;
+			_txCol += length;
+			return true;
+		}
+	}
+
+	while (_txPage < pages && _txDirtyX0[_txPage] > _txDirtyX1[_txPage]) _txPage++;
+	if (_txPage >= pages) return false;
+	uint8_t x0 = _txDirtyX0[_txPage];
+	uint8_t x1 = _txDirtyX1[_txPage];
+	_txLast = _txPage;
+	while (_txLast + 1 < pages && _txDirtyX0[_txLast + 1] == x0 && _txDirtyX1[_txLast + 1] == x1) _txLast++;
+
+	_txCmd[0] = SSD1306_SET_COLUMN_ADDR;
+	_txCmd[1] = x0;
+	_txCmd[2] = x1;
+	_txCmd[3] = SSD1306_SET_PAGE_ADDR;
+	_txCmd[4] = _txBank + _txPage;
+	_txCmd[5] = _txBank + _txLast;
+	segment.control = SSD1306_COMMAND;
+	segment.pData = _txCmd;
+	segment.length = sizeof(_txCmd);
+	_txCol = x0;
+	_txInWindow = true;
+	return true;
+}
+
+/*!
+	@brief Ends the transfer in progress, OLEDIsBusy turns false
+	@note Called by transports when the last segment is on the bus or the
+		transfer was aborted. Pages not taken yet stay marked for the next update.
+*/
+void SSD1306::OLEDTxEnd(void)
+{
+	_txInWindow = false;
+	_txBusy = false;
+}
+
+/*!
+	@brief Gets the I2C instance the display is on
+	@return i2c0 or i2c1
+*/
+i2c_inst* SSD1306::OLEDGetI2C(void) const {return this->i2CInst;}
+
+/*!
+	@brief Gets the I2C address of the display
+	@return 7 bit address
+*/
+uint16_t SSD1306::OLEDGetAddress(void) const {return this->address;}
+
+/*!
+	@brief Waits until a transport has nothing on the bus of the display , used internally
+	@details Called before every blocking transaction. Transfers of other
+		displays sharing the transport may be on the bus even when this
+		display is idle, the transaction must not cut into them. Behind a
+		multiplexer the transport of the display that opened the channel
+		is waited for as well, the channel switch would cut into it.
+*/
+void SSD1306::busWait(void)
+{
+	if (_pTransport != nullptr) _pTransport->waitBusFree(*this);
+	if (_pMux == nullptr) return;
+	SSD1306 *pOwner = _pMux->owner();
+	if (pOwner != nullptr && pOwner != this && pOwner->_pTransport != nullptr && pOwner->_pTransport != _pTransport)
+		pOwner->_pTransport->waitBusFree(*pOwner);
+}
+
+/*!
+	@brief Puts the display behind an I2C multiplexer
+	@param pMux multiplexer on the bus of the display , nullptr directly on the bus
+	@param channel multiplexer channel 0-7 the display is wired to
+	@details Every transaction then selects the channel first , the write is
+		skipped when the channel is open already. Call before OLEDinit.
+*/
+void SSD1306::OLEDSetMux(OLEDI2CMux* pMux, uint8_t channel)
+{
+	OLEDWaitIdle();
+	_pMux = pMux;
+	_muxChannel = channel;
+}
+
+/*! @brief Gets the multiplexer of the display @return multiplexer , nullptr if none */
+OLEDI2CMux* SSD1306::OLEDGetMux(void) const {return _pMux;}
+
+/*! @brief Gets the multiplexer channel of the display @return channel 0-7 */
+uint8_t SSD1306::OLEDGetMuxChannel(void) const {return _muxChannel;}
+
+/*!
+	@brief Opens the multiplexer channel of the display
+	@return false if the multiplexer did not switch , true if it did or there is none
+	@note Used by transports before they start a transaction , the bus must be free.
+		The display becomes the owner of the multiplexer.
+*/
+bool SSD1306::OLEDMuxSelect(void)
+{
+	if (_pMux == nullptr) return true;
+	if (!_pMux->select(_muxChannel)) return false;
+	_pMux->setOwner(this);
+	return true;
+}
+
+/*!
+	@brief Adds a second buffer and turns on double buffering
+	@param pBuffer pointer to buffer , nullptr turns double buffering off
+	@param sizeOfBuffer size of buffer , must equal the buffer set by OLEDSetBufferPtr
+	@return true for success
+	@details Drawing goes to the back buffer, OLEDupdate and OLEDupdateDirty send
+		the front buffer. OLEDSwapBuffers exchanges them. The current picture is
+		copied into the new buffer so both start equal.
+*/
+bool SSD1306::OLEDSetSecondBuffer(uint8_t* pBuffer, uint16_t sizeOfBuffer)
+{
+	OLEDWaitIdle();
+	if (pBuffer == nullptr)
+	{
+		if (_txBuffer != nullptr) takeDirty();
+		_txBuffer = nullptr;
+		return true;
+	}
+	if (this->OLEDbuffer == nullptr || sizeOfBuffer != this->bufferWidth * (this->bufferHeight / 8))
+	{
+		OLED_ERROR(OLED_BufferSize, "OLEDSetSecondBuffer 1", "buffer size does not equal the first buffer\r\n");
+		return false;
+	}
+	memcpy(pBuffer, this->OLEDbuffer, sizeOfBuffer);
+	_txBuffer = pBuffer;
+	return true;
+}
+
+/*!
+	@brief Checks if a second buffer is in use
+	@return true if double buffered
+*/
+bool SSD1306::OLEDIsDoubleBuffered(void) const {return _txBuffer != nullptr;}
+
+/*!
+	@brief Makes the finished back buffer the front buffer, a pointer swap
+	@param carryForward false the default , the new back buffer keeps the
+		picture of two frames ago, for frames drawn in full. true copy the
+		finished picture into it so drawing can continue from it.
+	@details Waits for a transfer of the front buffer to finish. The dirty areas
+		are handed to the next OLEDupdateDirty.
+	@note Only the default is O(1). With carryForward the whole buffer is
+		copied, drawing functions do not mark dirty so the marked areas can
+		not tell what changed.
+*/
+void SSD1306::OLEDSwapBuffers(bool carryForward)
+{
+	if (_txBuffer == nullptr) return;
+	OLEDWaitIdle();
+	uint8_t* pDone = this->OLEDbuffer;
+	this->OLEDbuffer = _txBuffer;
+	_txBuffer = pDone;
+
+	if (carryForward)
+		memcpy(this->OLEDbuffer, _txBuffer, this->bufferWidth * (this->bufferHeight / 8));
+	takeDirty();
+}
+
+/*!
+	@brief Checks for a transfer in progress
+	@return true while the front buffer is being sent
+*/
+bool SSD1306::OLEDIsBusy(void) const {return _txBusy;}
+
+/*!
+	@brief Waits for a transfer in progress to finish
+	@note A stepped update is sent to the end here.
+*/
+void SSD1306::OLEDWaitIdle(void)
+{
+	while (_txStepped) OLEDupdateStep(0);
+	while (_txBusy)
+	{
+		if (_pTransport != nullptr) _pTransport->serviceTransfer();
+		else tight_loop_contents();
+	}
+}
+
+/*!
+	@brief Moves the dirty areas of the drawing buffer to the areas to send , used internally
+*/
+void SSD1306::takeDirty(void)
+{
+	for (uint8_t page = 0; page < SSD1306_GDDRAM_PAGES; page++)
+	{
+		if (_dirtyX0[page] < _txDirtyX0[page]) _txDirtyX0[page] = _dirtyX0[page];
+		if (_dirtyX1[page] > _txDirtyX1[page]) _txDirtyX1[page] = _dirtyX1[page];
+	}
+	OLEDClearDirty();
+}
+
+/*!
+	@brief Gets the buffer sent to the screen , used internally
+	@return front buffer when double buffered, else the drawing buffer
+*/
+uint8_t* SSD1306::frontBuffer(void) const
+{
+	return (_txBuffer != nullptr) ? _txBuffer : this->OLEDbuffer;
+}
+
+/*!
+	@brief Marks a screen area as changed for OLEDupdateDirty
+	@param x x start coordinate
+	@param y y start coordinate
+	@param w width of the area
+	@param h height of the area
+	@note Coordinates follow the current rotation, the area is widened to whole pages.
+*/
+void SSD1306::markDirty(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+	uint8_t x0, x1, page0, page1;
+	if (!bufferArea(x, y, w, h, x0, x1, page0, page1)) return;
+
+	for (uint8_t page = page0; page <= page1; page++)
+	{
+		if (x0 < _dirtyX0[page]) _dirtyX0[page] = x0;
+		if (x1 > _dirtyX1[page]) _dirtyX1[page] = x1;
+	}
+}
+
+/*!
+	@brief Maps a screen area to buffer columns and pages , used internally
+	@param x x start coordinate
+	@param y y start coordinate
+	@param w width of the area
+	@param h height of the area
+	@param x0 first buffer column
+	@param x1 last buffer column
+	@param page0 first buffer page
+	@param page1 last buffer page
+	@return false if the area is empty or off the buffer
+	@note Coordinates follow the current rotation, the area is widened to whole pages.
+*/
+bool SSD1306::bufferArea(int16_t x, int16_t y, int16_t w, int16_t h,
+	uint8_t &x0, uint8_t &x1, uint8_t &page0, uint8_t &page1) const
+{
+	if (w <= 0 || h <= 0) return false;
+	int16_t left, top, right, bottom;
+	switch (_OLED_rotate)
+	{
+		case OLED_Degrees_90:
+			left = WIDTH - (y + h); right = WIDTH - 1 - y;
+			top = x; bottom = x + w - 1;
+		break;
+		case OLED_Degrees_180:
+			left = WIDTH - (x + w); right = WIDTH - 1 - x;
+			top = HEIGHT - (y + h); bottom = HEIGHT - 1 - y;
+		break;
+		case OLED_Degrees_270:
+			left = y; right = y + h - 1;
+			top = HEIGHT - (x + w); bottom = HEIGHT - 1 - x;
+		break;
+		default:
+			left = x; right = x + w - 1;
+			top = y; bottom = y + h - 1;
+		break;
+	}
+	if (left < 0) left = 0;
+	if (top < 0) top = 0;
+	if (right >= this->bufferWidth) right = this->bufferWidth - 1;
+	if (bottom >= this->bufferHeight) bottom = this->bufferHeight - 1;
+	if (left > right || top > bottom) return false;
+	x0 = left;
+	x1 = right;
+	page0 = top / 8;
+	page1 = bottom / 8;
+	return true;
+}
+
+/*!
+	@brief Forgets all areas marked with markDirty
+*/
+void SSD1306::OLEDClearDirty(void)
+{
+	memset(_dirtyX0, 0xFF, sizeof(_dirtyX0));
+	memset(_dirtyX1, 0x00, sizeof(_dirtyX1));
+}
+
+/*!
+	@brief Checks for areas waiting for OLEDupdateDirty
+	@return true if any area is marked
+*/
+bool SSD1306::OLEDIsDirty(void) const
+{
+	for (uint8_t page = 0; page < SSD1306_GDDRAM_PAGES; page++)
+	{
+		if (_dirtyX0[page] <= _dirtyX1[page] || _txDirtyX0[page] <= _txDirtyX1[page]) return true;
+	}
+	return false;
+}
+
+/*!
+	@brief Gets the changed columns of one page
+	@param page buffer page
+	@param x0 first changed column
+	@param x1 last changed column
+	@return false if nothing in the page is marked
+*/
+bool SSD1306::OLEDGetDirty(uint8_t page, uint8_t &x0, uint8_t &x1) const
+{
+	if (page >= SSD1306_GDDRAM_PAGES || _dirtyX0[page] > _dirtyX1[page]) return false;
+	x0 = _dirtyX0[page];
+	x1 = _dirtyX1[page];
+	return true;
+}
+
+/*!
+	@brief Marks a run of buffer columns of one page dirty
+	@param page buffer page 0-7
+	@param x0 first buffer column
+	@param x1 last buffer column
+	@note Buffer coordinates, not rotated, e.g. to merge the result of OLEDGetDirty
+		from another object drawing into the same buffer.
+*/
+void SSD1306::OLEDMarkDirtyColumns(uint8_t page, uint8_t x0, uint8_t x1)
+{
+	if (page >= SSD1306_GDDRAM_PAGES || x0 > x1) return;
+	if (x0 < _dirtyX0[page]) _dirtyX0[page] = x0;
+	if (x1 > _dirtyX1[page]) _dirtyX1[page] = x1;
+}
+
+/*!
+	@brief Sets the memory used to save regions of the buffer
+	@param pArena pointer to memory
+	@param sizeOfArena size of memory in bytes
+	@note Drops any saved regions.
+*/
+void SSD1306::OLEDSetRegionArena(uint8_t* pArena, uint16_t sizeOfArena)
+{
+	_pRegionArena = pArena;
+	_regionArenaSize = (pArena != nullptr) ? sizeOfArena : 0;
+	_regionDepth = 0;
+}
+
+/*!
+	@brief Saves the buffer bytes under an area, such as before drawing a dialog
+	@param x x start coordinate
+	@param y y start coordinate
+	@param w width of the area
+	@param h height of the area
+	@param compress true store runs of equal bytes as count, value pairs ,
+		kept only if smaller than the plain copy
+	@return false if the stack is full or the arena is too small
+	@note The area is widened to whole pages. Coordinates follow the current rotation,
+		do not change rotation while regions are saved.
+*/
+bool SSD1306::OLEDPushRegion(int16_t x, int16_t y, int16_t w, int16_t h, bool compress)
+{
+	uint8_t x0, x1, page0, page1;
+	if (!bufferArea(x, y, w, h, x0, x1, page0, page1)) return false;
+	if (_regionDepth >= SSD1306_REGION_DEPTH || _pRegionArena == nullptr)
+	{
+		OLED_ERROR(OLED_RegionStack, "pushRegion 1", "Region stack full or no arena set\r\n");
+		return false;
+	}
+
+	OLEDRegion_t &region = _regions[_regionDepth];
+	region.offset = (_regionDepth > 0) ? _regions[_regionDepth - 1].offset + _regions[_regionDepth - 1].length : 0;
+	region.x0 = x0;
+	region.x1 = x1;
+	region.page0 = page0;
+	region.page1 = page1;
+	const uint8_t span = x1 - x0 + 1;
+	const uint16_t rawLength = span * (page1 - page0 + 1);
+	const uint16_t space = _regionArenaSize - region.offset;
+	uint8_t* pOut = _pRegionArena + region.offset;
+
+	region.rle = false;
+	if (compress)
+	{
+		// count, value pairs , abandoned once no smaller than the plain copy
+		uint16_t length = 0;
+		const uint16_t limit = (rawLength < space) ? rawLength : space;
+		for (uint8_t page = page0; page <= page1 && length < limit; page++)
+		{
+			const uint8_t* pIn = &this->OLEDbuffer[(bufferWidth * page) + x0];
+			uint8_t i = 0;
+			while (i < span && length + 2 <= limit)
+			{
+				uint8_t run = 1;
+				while (i + run < span && run < 255 && pIn[i + run] == pIn[i]) run++;
+				pOut[length++] = run;
+				pOut[length++] = pIn[i];
+				i += run;
+			}
+			if (i < span) length = limit; // ran out of room
+		}
+		if (length < limit)
+		{
+			region.rle = true;
+			region.length = length;
+		}
+	}
+	if (!region.rle)
+	{
+		if (rawLength > space)
+		{
+			OLED_ERROR(OLED_RegionStack, "pushRegion 2", "Region arena too small, %u bytes free\r\n", space);
+			return false;
+		}
+		for (uint8_t page = page0; page <= page1; page++)
+			memcpy(pOut + (page - page0) * span, &this->OLEDbuffer[(bufferWidth * page) + x0], span);
+		region.length = rawLength;
+	}
+	_regionDepth++;
+	return true;
+}
+
+/*!
+	@brief Restores the last saved region and marks it dirty
+	@return false if no region is saved
+*/
+bool SSD1306::OLEDPopRegion(void)
+{
+	if (_regionDepth == 0)
+	{
+		OLED_ERROR(OLED_RegionStack, "popRegion 1", "No region saved\r\n");
+		return false;
+	}
+	const OLEDRegion_t &region = _regions[--_regionDepth];
+	const uint8_t span = region.x1 - region.x0 + 1;
+	const uint8_t* pIn = _pRegionArena + region.offset;
+
+	uint8_t page = region.page0;
+	uint8_t column = 0;
+	if (region.rle)
+	{
+		for (uint16_t i = 0; i + 1 < region.length; i += 2)
+		{
+			for (uint8_t run = pIn[i]; run > 0; run--)
+			{
+				this->OLEDbuffer[(bufferWidth * page) + region.x0 + column] = pIn[i + 1];
+				if (++column == span) {column = 0; page++;}
+			}
+		}
+	}
+	else
+	{
+		for (; page <= region.page1; page++)
+			memcpy(&this->OLEDbuffer[(bufferWidth * page) + region.x0], pIn + (page - region.page0) * span, span);
+	}
+
+	for (page = region.page0; page <= region.page1; page++)
+	{
+		if (region.x0 < _dirtyX0[page]) _dirtyX0[page] = region.x0;
+		if (region.x1 > _dirtyX1[page]) _dirtyX1[page] = region.x1;
+	}
+	return true;
+}
+
+/*!
+	@brief Gets the number of saved regions
+	@return stack depth 0 - SSD1306_REGION_DEPTH
+*/
+uint8_t SSD1306::OLEDRegionDepth(void) const {return _regionDepth;}
+
+/*!
+	@brief Gets the arena bytes held by saved regions
+	@return bytes used
+*/
+uint16_t SSD1306::OLEDRegionArenaUsed(void) const
+{
+	return (_regionDepth > 0) ? _regions[_regionDepth - 1].offset + _regions[_regionDepth - 1].length : 0;
 }
 
 /*!
@@ -348,6 +1182,9 @@ void SSD1306::drawPixel(int16_t x, int16_t y, uint8_t color)
 		return;
 		}
 	}
+	if ((x < _clipX0) || (x >= _clipX1) || (y < _clipY0) || (y >= _clipY1)) {
+		return;
+	}
 	int16_t temp;
 	switch (rotation) {
 	case 1:
@@ -374,17 +1211,63 @@ void SSD1306::drawPixel(int16_t x, int16_t y, uint8_t color)
 		}
 }
 
+/*!
+	@brief Draws a vertical run of pixels a buffer byte at a time
+	@param x x axis  position
+	@param y y axis  position of the top pixel
+	@param bits pixel data, bit 0 is the top pixel
+	@param height number of pixels in the run 1-32
+	@param color color of set bits
+	@param bg color of clear bits, if equal to color clear bits are left untouched
+	@note Used by drawChar, rotated screens fall back to drawPixel.
+*/
+void SSD1306::drawColumnBits(int16_t x, int16_t y, uint32_t bits, uint8_t height, uint8_t color, uint8_t bg)
+{
+	if (getRotation() != OLED_Degrees_0)
+	{
+		SSD1306_graphics::drawColumnBits(x, y, bits, height, color, bg);
+		return;
+	}
+	// trim the run to the clip rectangle
+	int16_t top = (y < _clipY0) ? _clipY0 : y;
+	int16_t bottom = (y + height > _clipY1) ? _clipY1 : (y + height);
+	if ((x < _clipX0) || (x >= _clipX1) || (x >= this->bufferWidth) || (top >= bottom)) {
+		return;
+	}
+
+	uint64_t mask = ((1ULL << (bottom - y)) - 1) & ~((1ULL << (top - y)) - 1);
+	uint64_t fgMask = bits & mask;
+	uint64_t bgMask = (bg != color) ? (~(uint64_t)bits & mask) : 0;
+	// move bit (top - y) to its position in the page of top
+	fgMask = (fgMask >> (top - y)) << (top & 7);
+	bgMask = (bgMask >> (top - y)) << (top & 7);
+	mask = (mask >> (top - y)) << (top & 7);
+	y = top;
+
+	uint8_t* pByte = &this->OLEDbuffer[(bufferWidth * (y /8)) + x];
+	for (int16_t page = y/8; mask && page < (this->bufferHeight/8); page++)
+	{
+		OLEDApplyColor(*pByte, color, (uint8_t)fgMask);
+		OLEDApplyColor(*pByte, bg, (uint8_t)bgMask);
+		fgMask >>= 8;
+		bgMask >>= 8;
+		mask >>= 8;
+		pByte += bufferWidth;
+	}
+}
+
 /*!
 	@brief Scroll OLED data to the right
 	@param start start position
 	@param stop stop position 
+	@param interval frames per column step
 */
-void SSD1306::OLEDStartScrollRight(uint8_t start, uint8_t stop) 
+void SSD1306::OLEDStartScrollRight(uint8_t start, uint8_t stop, OLEDScrollInterval_e interval) 
 {
 	SSD1306_command(SSD1306_RIGHT_HORIZONTAL_SCROLL);
 	SSD1306_command(0X00);
 	SSD1306_command(start);  // start page
-	SSD1306_command(0X00);
+	SSD1306_command(interval);
 	SSD1306_command(stop);   // end page
 	SSD1306_command(0X00);
 	SSD1306_command(0XFF);
@@ -395,13 +1278,14 @@ void SSD1306::OLEDStartScrollRight(uint8_t start, uint8_t stop)
 	@brief Scroll OLED data to the left
 	@param start start position
 	@param stop stop position 
+	@param interval frames per column step
 */
-void SSD1306::OLEDStartScrollLeft(uint8_t start, uint8_t stop) 
+void SSD1306::OLEDStartScrollLeft(uint8_t start, uint8_t stop, OLEDScrollInterval_e interval) 
 {
 	SSD1306_command(SSD1306_LEFT_HORIZONTAL_SCROLL);
 	SSD1306_command(0X00);
 	SSD1306_command(start);
-	SSD1306_command(0X00);
+	SSD1306_command(interval);
 	SSD1306_command(stop);
 	SSD1306_command(0X00);
 	SSD1306_command(0XFF);
@@ -461,6 +1345,9 @@ void SSD1306::OLEDStopScroll(void)
 uint8_t SSD1306::OLEDCheckConnection(void)
 {
 	uint8_t rxdata; //buffer to hold return byte
+	OLEDWaitIdle();
+	busWait();
+	OLEDMuxSelect();
 
 	return i2c_read_blocking(this->i2CInst, this->address, &rxdata, 1, false); // returns number if bytes read
 }
@@ -59,6 +59,7 @@
 // Timing & Driving Scheme Setting Commands
 #define SSD1306_SET_DISPLAY_CLOCK_DIV_RATIO  0xD5
 #define SSD1306_SET_PRECHARGE_PERIOD         0xD9
+#define SSD1306_PRECHARGE_INIT               0xF1 /**< Pre-charge set by OLEDinit, phase 2 high nibble, phase 1 low */
 #define SSD1306_SET_VCOM_DESELECT            0xDB
 
 // I2C related
@@ -78,6 +79,61 @@
 // Delays
 #define SSD1306_INITDELAY 100 /**< Initialisation delay in mS */
 
+#ifndef SSD1306_I2C_CHUNK
+#define SSD1306_I2C_CHUNK 32 /**< Max data bytes per I2C transaction in bulk writes */
+#endif
+#define SSD1306_GDDRAM_PAGES 8 /**< Pages of display RAM in the controller, any panel height */
+#ifndef SSD1306_STEP_US_PER_BYTE
+#define SSD1306_STEP_US_PER_BYTE 25 /**< First guess of I2C time per byte for OLEDupdateStep, 400kHz bus */
+#endif
+#define SSD1306_STEP_MIN_BYTES 8 /**< Smallest OLEDupdateStep budget, a window command or one data byte */
+#ifndef SSD1306_REGION_DEPTH
+#define SSD1306_REGION_DEPTH 4 /**< Maximum number of nested save-under regions */
+#endif
+
+/*! Enum to define the hardware scroll step interval, in frames per column */
+enum OLEDScrollInterval_e : uint8_t
+{
+	OLEDScroll_2Frames = 0x07,   /**< one column every 2 frames */
+	OLEDScroll_3Frames = 0x04,   /**< one column every 3 frames */
+	OLEDScroll_4Frames = 0x05,   /**< one column every 4 frames */
+	OLEDScroll_5Frames = 0x00,   /**< one column every 5 frames */
+	OLEDScroll_25Frames = 0x06,  /**< one column every 25 frames */
+	OLEDScroll_64Frames = 0x01,  /**< one column every 64 frames */
+	OLEDScroll_128Frames = 0x02, /**< one column every 128 frames */
+	OLEDScroll_256Frames = 0x03  /**< one column every 256 frames */
+};
+
+/*!
+	@brief Struct to hold one I2C transaction of a transfer, a control byte then data
+*/
+struct OLEDTxSegment_t
+{
+	uint8_t control;       /**< Control byte, SSD1306_COMMAND or SSD1306_DATA_CONTINUE */
+	const uint8_t* pData;  /**< Bytes following the control byte */
+	uint16_t length;       /**< Number of bytes at pData */
+};
+
+class SSD1306;
+class OLEDI2CMux;
+
+/*!
+	@brief interface for a transport sending the segments of a transfer in the background
+	@details startTransfer takes segments with OLEDTxNextSegment until it returns
+		false and calls OLEDTxEnd when the last one is on the bus. A polled
+		transport moves the transfer on in serviceTransfer, OLEDWaitIdle calls it.
+		waitBusFree returns once none of its bytes are on the bus of the
+		display, blocking transactions of the display call it first.
+*/
+class OLEDTxTransport
+{
+  public:
+	virtual ~OLEDTxTransport(){};
+	virtual bool startTransfer(SSD1306 &oled) = 0;
+	virtual void serviceTransfer(void) {};
+	virtual void waitBusFree(SSD1306 &oled) {(void)oled;};
+};
+
 /*!
 	@brief class to control OLED and define buffer
 */
@@ -87,15 +143,40 @@ class SSD1306 : public SSD1306_graphics  {
 	~SSD1306(){};
 
 	virtual void drawPixel(int16_t x, int16_t y, uint8_t color) override;
+	virtual void drawColumnBits(int16_t x, int16_t y, uint32_t bits, uint8_t height,
+	  uint8_t color, uint8_t bg) override;
 	void OLEDupdate(void);
+	void OLEDupdateDirty(void);
+	void OLEDupdateStart(bool fullFrame = false);
+	bool OLEDupdateStep(uint16_t maxBytes, uint32_t maxMicros = 0);
+	uint16_t OLEDupdatePending(void) const;
 	void OLEDclearBuffer(void);
+	virtual void markDirty(int16_t x, int16_t y, int16_t w, int16_t h) override;
+	void OLEDClearDirty(void);
+	bool OLEDIsDirty(void) const;
+	bool OLEDGetDirty(uint8_t page, uint8_t &x0, uint8_t &x1) const;
+	void OLEDMarkDirtyColumns(uint8_t page, uint8_t x0, uint8_t x1);
 	void OLEDBufferScreen(int16_t x, int16_t y, uint8_t w, uint8_t h, uint8_t* data);
 	void OLEDFillScreen(uint8_t pixel, uint8_t mircodelay);
 	void OLEDFillPage(uint8_t page_num, uint8_t pixels,uint8_t delay);
+	void OLEDSetRegionArena(uint8_t* pArena, uint16_t sizeOfArena);
+	bool OLEDPushRegion(int16_t x, int16_t y, int16_t w, int16_t h, bool compress = false);
+	bool OLEDPopRegion(void);
+	uint8_t OLEDRegionDepth(void) const;
+	uint16_t OLEDRegionArenaUsed(void) const;
 	OLED_Return_Codes_e  OLEDBitmap(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t* data, bool invert);
 
 	void OLEDbegin(i2c_inst *i2c_instance, uint16_t address= SSD1306_ADDR);
 	bool OLEDSetBufferPtr(uint8_t width, uint8_t height , uint8_t* pBuffer, uint16_t sizeOfBuffer);
+	uint8_t* OLEDGetBufferPtr(void) const;
+	bool OLEDSetSecondBuffer(uint8_t* pBuffer, uint16_t sizeOfBuffer);
+	bool OLEDIsDoubleBuffered(void) const;
+	void OLEDSwapBuffers(bool carryForward = false);
+	bool OLEDSetPageFlip(bool on);
+	bool OLEDIsPageFlip(void) const;
+	void OLEDPresent(void);
+	bool OLEDIsBusy(void) const;
+	void OLEDWaitIdle(void);
 	void OLEDinit(void);
 	void OLEDPowerDown(void);
 
@@ -103,17 +184,41 @@ class SSD1306 : public SSD1306_graphics  {
 	void OLEDContrast(uint8_t OLEDcontrast);
 	void OLEDInvert(bool on);
 
-	void OLEDStartScrollRight(uint8_t start, uint8_t stop);
-	void OLEDStartScrollLeft(uint8_t start, uint8_t stop) ;
+	void OLEDStartScrollRight(uint8_t start, uint8_t stop, OLEDScrollInterval_e interval = OLEDScroll_5Frames);
+	void OLEDStartScrollLeft(uint8_t start, uint8_t stop, OLEDScrollInterval_e interval = OLEDScroll_5Frames);
 	void OLEDStartScrollDiagRight(uint8_t start, uint8_t stop) ;
 	void OLEDStartScrollDiagLeft(uint8_t start, uint8_t stop) ;
 	void OLEDStopScroll(void) ;
 
+	void OLEDSetStartLine(uint8_t line);
+	void OLEDSetWindow(uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1);
+	void OLEDWriteData(const uint8_t* data, uint16_t length);
+
+	void OLEDSetTransport(OLEDTxTransport* pTransport);
+	bool OLEDTxNextSegment(OLEDTxSegment_t &segment, uint16_t maxData);
+	void OLEDTxEnd(void);
+	i2c_inst* OLEDGetI2C(void) const;
+	uint16_t OLEDGetAddress(void) const;
+	void OLEDSetMux(OLEDI2CMux* pMux, uint8_t channel);
+	OLEDI2CMux* OLEDGetMux(void) const;
+	uint8_t OLEDGetMuxChannel(void) const;
+	bool OLEDMuxSelect(void);
+
 	uint8_t OLEDCheckConnection(void);
 
   private:
 
 	void I2C_Write_Byte(unsigned char value, unsigned char cmd);
+	void I2C_Write_Commands(const uint8_t* cmds, uint8_t length);
+	void takeDirty(void);
+	void sendFrame(uint8_t firstPage);
+	void txBegin(bool fullFrame, uint8_t firstPage);
+	void txRun(void);
+	void txWrite(const OLEDTxSegment_t &segment);
+	void busWait(void);
+	uint8_t* frontBuffer(void) const;
+	bool bufferArea(int16_t x, int16_t y, int16_t w, int16_t h,
+	  uint8_t &x0, uint8_t &x1, uint8_t &page0, uint8_t &page1) const;
 	
     i2c_inst *i2CInst;
     uint16_t address;
@@ -125,5 +230,42 @@ class SSD1306 : public SSD1306_graphics  {
 	uint8_t bufferHeight ;    /**< Height of Screen Buffer */
 
 	uint8_t* OLEDbuffer = nullptr; /**< pointer to buffer which holds screen data */
+	uint8_t* _txBuffer = nullptr;  /**< Front buffer sent to the screen when double buffered, else nullptr */
+	volatile bool _txBusy = false; /**< A transfer from the front buffer is in progress */
+	bool _pageFlip = false;        /**< Frames alternate between banks of display RAM */
+	uint8_t _flipBank = 0;         /**< Display RAM bank shown, bank n starts at page n * pages of panel */
+
+	uint8_t _dirtyX0[SSD1306_GDDRAM_PAGES]; /**< First changed column per page, > _dirtyX1 when clean */
+	uint8_t _dirtyX1[SSD1306_GDDRAM_PAGES]; /**< Last changed column per page */
+	uint8_t _txDirtyX0[SSD1306_GDDRAM_PAGES]; /**< First column per page waiting to be sent, > _txDirtyX1 when clean */
+	uint8_t _txDirtyX1[SSD1306_GDDRAM_PAGES]; /**< Last column per page waiting to be sent */
+
+	OLEDTxTransport* _pTransport = nullptr; /**< Sends transfers in the background, nullptr blocking */
+	uint8_t _txBank = 0;     /**< Display RAM page the top of the buffer goes to */
+	uint8_t _txPage = 0;     /**< Page of the transfer being sent */
+	uint8_t _txLast = 0;     /**< Last page of the window being sent */
+	uint8_t _txCol = 0;      /**< Next column of the page being sent */
+	bool _txInWindow = false; /**< A window was set and its pages are being sent */
+	uint8_t _txCmd[6];       /**< Window command bytes of the current segment */
+	bool _txStepped = false; /**< Transfer in progress is sent by OLEDupdateStep */
+	uint16_t _txUsPerByte16 = SSD1306_STEP_US_PER_BYTE * 16; /**< Measured I2C time per byte, 1/16 us */
+	OLEDI2CMux* _pMux = nullptr; /**< Multiplexer the display is behind, nullptr directly on the bus */
+	uint8_t _muxChannel = 0;     /**< Multiplexer channel of the display */
+
+	/*! @brief one saved region of the buffer */
+	struct OLEDRegion_t
+	{
+		uint16_t offset;  /**< Start of saved bytes in the arena */
+		uint16_t length;  /**< Number of bytes used in the arena */
+		uint8_t x0;       /**< First buffer column */
+		uint8_t x1;       /**< Last buffer column */
+		uint8_t page0;    /**< First buffer page */
+		uint8_t page1;    /**< Last buffer page */
+		bool rle;         /**< Bytes are stored as count, value pairs */
+	};
+	uint8_t* _pRegionArena = nullptr;             /**< Memory for saved regions */
+	uint16_t _regionArenaSize = 0;                /**< Size of region arena */
+	OLEDRegion_t _regions[SSD1306_REGION_DEPTH];  /**< Saved regions, last is on top */
+	uint8_t _regionDepth = 0;                     /**< Number of saved regions */
 
 };
@@ -0,0 +1,250 @@
+/*!
+	@file ssd1306_oled_bands.cpp
+	@brief OLED driven by SSD1306 controller. Source file
+		for the banded two core renderer.
+*/
+
+#include "ssd1306_oled_bands.h"
+
+OLEDBandRenderer * volatile OLEDBandRenderer::_pCore1Renderer = nullptr;
+
+/*!
+	@brief Constructor
+	@param oled display object, must have its buffer set before rendering
+	@param width width of buffer in pixels
+	@param height height of buffer in pixels
+*/
+OLEDBandRenderer::OLEDBandRenderer(SSD1306 &oled, uint8_t width, uint8_t height) :
+	_oled(oled), _worker(width, height), _width(width), _height(height)
+{
+	_split = (height / 8) / 2;
+}
+
+/*!
+	@brief Starts the band worker on core1 , on a thread on host builds
+	@return false if it runs already or core1 is taken by another renderer
+*/
+bool OLEDBandRenderer::start(void)
+{
+	if (_running || _pCore1Renderer != nullptr) return false;
+	_pCore1Renderer = this;
+	_running = true;
+#if PICO_ON_DEVICE
+	multicore_launch_core1(core1Entry);
+#else
+	_job = 0;
+	_thread = std::thread(core1Entry);
+#endif
+	return true;
+}
+
+/*!
+	@brief Stops the band worker, later frames are drawn on the calling core
+*/
+void OLEDBandRenderer::stop(void)
+{
+	if (!_running) return;
+#if PICO_ON_DEVICE
+	multicore_fifo_push_blocking(0);
+	while (_pCore1Renderer != nullptr) tight_loop_contents();
+	multicore_reset_core1();
+#else
+	{
+		std::lock_guard<std::mutex> guard(_lock);
+		_job = -1;
+	}
+	_wake.notify_all();
+	_thread.join();
+#endif
+	_running = false;
+}
+
+/*!
+	@brief Checks if band 1 is drawn by the other core
+	@return true while started
+*/
+bool OLEDBandRenderer::isRunning(void) const {return _running;}
+
+/*!
+	@brief Replays a display list into both bands
+	@param list display list, ops are culled per band
+	@return number of ops drawn, an op crossing the split counts twice
+	@details The boxes of the ops drawn are marked dirty on the display object.
+*/
+uint16_t OLEDBandRenderer::render(const OLEDDisplayList &list)
+{
+	_pList = &list;
+	_draw = nullptr;
+	renderBands();
+	_pList = nullptr;
+	return _drawn[0] + _drawn[1];
+}
+
+/*!
+	@brief Runs a draw callback once per band
+	@param draw callback drawing the whole screen, pixels outside its band are clipped
+	@param pContext user pointer passed to the callback
+	@note The callback runs on both cores at the same time, it must not
+		change shared data. Areas it marks dirty in either band end up on
+		the display object.
+*/
+void OLEDBandRenderer::render(OLEDBandDraw_t draw, void *pContext)
+{
+	if (draw == nullptr) return;
+	_pList = nullptr;
+	_draw = draw;
+	_pContext = pContext;
+	renderBands();
+	_draw = nullptr;
+}
+
+/*!
+	@brief Moves the split between the bands
+	@param page first page of band 1, 1 to pages - 1
+	@note Use bandTimeUs to balance a screen with more detail at one end.
+*/
+void OLEDBandRenderer::setSplit(uint8_t page)
+{
+	uint8_t pages = _height / 8;
+	if (page < 1) page = 1;
+	if (page > pages - 1) page = pages - 1;
+	_split = page;
+}
+
+/*!
+	@brief Gets the first page of band 1
+	@return page number
+*/
+uint8_t OLEDBandRenderer::split(void) const {return _split;}
+
+/*!
+	@brief Gets the time a band took in the last render
+	@param band 0 upper band, 1 lower band
+	@return time in microseconds
+*/
+uint32_t OLEDBandRenderer::bandTimeUs(uint8_t band) const
+{
+	return (band < 2) ? _timeUs[band] : 0;
+}
+
+/*!
+	@brief Draws both bands and waits for both , used internally
+*/
+void OLEDBandRenderer::renderBands(void)
+{
+	uint8_t *pBuffer = _oled.OLEDGetBufferPtr();
+	if (pBuffer == nullptr) return;
+	_worker.OLEDSetBufferPtr(_width, _height, pBuffer, _width * (_height / 8));
+	if (_worker.getRotation() != _oled.getRotation())
+		_worker.setRotation(_oled.getRotation());
+	_clip = _oled.getClipRect();
+	_worker.OLEDClearDirty();
+
+	if (!_running)
+	{
+		renderBand(0);
+		renderBand(1);
+	}
+	else
+	{
+#if PICO_ON_DEVICE
+		multicore_fifo_push_blocking(1);
+		renderBand(0);
+		multicore_fifo_pop_blocking(); // barrier, band 1 done
+#else
+		{
+			std::lock_guard<std::mutex> guard(_lock);
+			_job = 1;
+		}
+		_wake.notify_all();
+		renderBand(0);
+		std::unique_lock<std::mutex> guard(_lock);
+		_wake.wait(guard, [this] {return _job == 0;}); // barrier, band 1 done
+#endif
+	}
+	mergeDirty();
+}
+
+/*!
+	@brief Marks what the job drew dirty on the display object , used internally
+	@details A list marks its op boxes. The marks a callback made in band 1
+		went to the worker and are moved over.
+*/
+void OLEDBandRenderer::mergeDirty(void)
+{
+	if (_pList != nullptr)
+	{
+		_pList->markDirty(_oled);
+		return;
+	}
+	uint8_t x0, x1;
+	for (uint8_t page = 0; page < SSD1306_GDDRAM_PAGES; page++)
+		if (_worker.OLEDGetDirty(page, x0, x1)) _oled.OLEDMarkDirtyColumns(page, x0, x1);
+	_worker.OLEDClearDirty();
+}
+
+/*!
+	@brief Draws the job into one band , used internally
+	@param band 0 upper band on the display object, 1 lower band on the worker
+*/
+void OLEDBandRenderer::renderBand(uint8_t band)
+{
+	uint64_t start = time_us_64();
+	SSD1306 &gfx = (band == 0) ? _oled : _worker;
+	_drawn[band] = 0;
+
+	// buffer rows of the band, mapped back to screen coordinates
+	int16_t top = (band == 0) ? 0 : _split * 8;
+	int16_t rows = (band == 0) ? _split * 8 : _height - (_split * 8);
+	int16_t bx = 0, by = 0, bw = gfx.width(), bh = gfx.height();
+	switch (gfx.getRotation())
+	{
+		case OLED_Degrees_90:  bx = top; bw = rows; break;
+		case OLED_Degrees_180: by = _height - top - rows; bh = rows; break;
+		case OLED_Degrees_270: bx = _height - top - rows; bw = rows; break;
+		default:               by = top; bh = rows; break;
+	}
+	int16_t x0 = (bx > _clip.x) ? bx : _clip.x;
+	int16_t y0 = (by > _clip.y) ? by : _clip.y;
+	int16_t x1 = (bx + bw < _clip.x + _clip.w) ? bx + bw : _clip.x + _clip.w;
+	int16_t y1 = (by + bh < _clip.y + _clip.h) ? by + bh : _clip.y + _clip.h;
+
+	if (x1 > x0 && y1 > y0)
+	{
+		gfx.setClipRect(x0, y0, x1 - x0, y1 - y0);
+		if (_pList != nullptr)
+			_drawn[band] = _pList->replay(gfx);
+		else
+			_draw(gfx, _pContext);
+		gfx.setClipRect(_clip.x, _clip.y, _clip.w, _clip.h);
+	}
+	_timeUs[band] = (uint32_t)(time_us_64() - start);
+}
+
+/*!
+	@brief Band worker loop of core1 , used internally
+*/
+void OLEDBandRenderer::core1Entry(void)
+{
+#if PICO_ON_DEVICE
+	while (multicore_fifo_pop_blocking() != 0)
+	{
+		_pCore1Renderer->renderBand(1);
+		multicore_fifo_push_blocking(1);
+	}
+#else
+	OLEDBandRenderer *pRenderer = _pCore1Renderer;
+	std::unique_lock<std::mutex> guard(pRenderer->_lock);
+	for (;;)
+	{
+		pRenderer->_wake.wait(guard, [pRenderer] {return pRenderer->_job != 0;});
+		if (pRenderer->_job < 0) break;
+		guard.unlock();
+		pRenderer->renderBand(1);
+		guard.lock();
+		pRenderer->_job = 0;
+		pRenderer->_wake.notify_all();
+	}
+#endif
+	_pCore1Renderer = nullptr;
+}
@@ -0,0 +1,82 @@
+/*!
+	@file ssd1306_oled_bands.h
+	@brief OLED driven by SSD1306 controller. header file
+		for the banded two core renderer.
+	@details Splits the frame buffer into two bands of whole pages. Core0
+		draws the upper band, core1 the lower one, each through its own
+		graphics object clipped to its band, so the cores never write the
+		same byte and keep separate cursor, font and clip state. render()
+		returns once both bands are done, the frame can then be flushed.
+*/
+
+#pragma once
+
+#include "ssd1306_oled.h"
+#include "ssd1306_oled_displaylist.h"
+#if PICO_ON_DEVICE
+#include "pico/multicore.h"
+#else
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+
+/*!
+	@brief draw callback run once per band
+	@param gfx graphics object clipped to the band, set its text state in the callback
+	@param pContext user pointer passed to render
+*/
+typedef void (*OLEDBandDraw_t)(SSD1306_graphics &gfx, void *pContext);
+
+/*!
+	@brief class to render a frame on both cores
+	@note On the device start() launches core1, it can not run the flush
+		service at the same time. Without start() both bands are drawn on the
+		calling core. On host builds start() runs a std::thread standing in
+		for core1, a condition variable takes the place of the FIFO.
+*/
+class OLEDBandRenderer
+{
+  public:
+	OLEDBandRenderer(SSD1306 &oled, uint8_t width, uint8_t height);
+
+	bool start(void);
+	void stop(void);
+	bool isRunning(void) const;
+
+	uint16_t render(const OLEDDisplayList &list);
+	void render(OLEDBandDraw_t draw, void *pContext);
+
+	void setSplit(uint8_t page);
+	uint8_t split(void) const;
+	uint32_t bandTimeUs(uint8_t band) const;
+
+  private:
+
+	void renderBands(void);
+	void renderBand(uint8_t band);
+	void mergeDirty(void);
+	static void core1Entry(void);
+
+	SSD1306 &_oled;                 /**< Display object, draws band 0 */
+	SSD1306 _worker;                /**< Graphics object sharing the buffer, draws band 1 */
+	uint8_t _width;                 /**< Width of buffer in pixels */
+	uint8_t _height;                /**< Height of buffer in pixels */
+	uint8_t _split;                 /**< First page of band 1 */
+	bool _running = false;          /**< Band 1 is drawn by the other core */
+
+	const OLEDDisplayList *_pList = nullptr; /**< Job: list to replay, or nullptr */
+	OLEDBandDraw_t _draw = nullptr;  /**< Job: callback when no list */
+	void *_pContext = nullptr;       /**< Job: callback user pointer */
+	OLEDRect_t _clip{};              /**< Job: clip rectangle of the display object */
+	uint16_t _drawn[2] = {0, 0};     /**< Ops drawn per band by the last list job */
+	uint32_t _timeUs[2] = {0, 0};    /**< Time per band of the last job */
+
+#if !PICO_ON_DEVICE
+	std::thread _thread;            /**< Stands in for core1 on host builds */
+	std::mutex _lock;               /**< Guards _job on host builds */
+	std::condition_variable _wake;  /**< Signals a change of _job on host builds */
+	int8_t _job = 0;                /**< Host handshake , 1 band 1 posted , 0 done , -1 stop */
+#endif
+	static OLEDBandRenderer * volatile _pCore1Renderer; /**< Renderer served by core1Entry , cleared by core1 when it stops */
+};
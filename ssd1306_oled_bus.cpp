@@ -0,0 +1,302 @@
+/*!
+	@file ssd1306_oled_bus.cpp
+	@brief OLED driven by SSD1306 controller. Source file
+		for the multi display bus scheduler.
+*/
+
+#include "ssd1306_oled_bus.h"
+#include "ssd1306_oled_mux.h"
+
+/*!
+	@brief Adds a display, the scheduler becomes its transport
+	@param oled display, OLEDbegin must have been called
+	@param priority higher is served first
+	@return false if OLED_BUS_MAX_DISPLAYS are added already
+*/
+bool OLEDBusScheduler::addDisplay(SSD1306 &oled, uint8_t priority)
+{
+	if (_count >= OLED_BUS_MAX_DISPLAYS) return false;
+	uint8_t bus = i2c_hw_index(oled.OLEDGetI2C());
+	OLEDBusLane_t &lane = _lanes[bus];
+#if PICO_ON_DEVICE
+	if (lane.dmaChannel < 0)
+	{
+		lane.dmaChannel = dma_claim_unused_channel(true);
+		i2c_hw_t *hw = i2c_get_hw(oled.OLEDGetI2C());
+		hw->dma_tdlr = 4;
+		hw->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS;
+	}
+#endif
+	lane.open = true;
+	_displays[_count] = OLEDBusDisplay_t{&oled, bus, priority, false};
+	_count++;
+	oled.OLEDSetTransport(this);
+	return true;
+}
+
+/*!
+	@brief Sends all queued updates, returns the displays to blocking updates
+*/
+void OLEDBusScheduler::end(void)
+{
+	waitIdle();
+	for (uint8_t i = 0; i < _count; i++)
+		_displays[i].pOled->OLEDSetTransport(nullptr);
+	for (uint8_t bus = 0; bus < OLED_BUS_COUNT; bus++)
+	{
+		OLEDBusLane_t &lane = _lanes[bus];
+		if (!lane.open) continue;
+		lane.open = false;
+#if PICO_ON_DEVICE
+		i2c_get_hw(bus == 0 ? i2c0 : i2c1)->dma_cr = 0;
+		dma_channel_unclaim(lane.dmaChannel);
+		lane.dmaChannel = -1;
+#endif
+	}
+	_count = 0;
+}
+
+/*!
+	@brief Queues the prepared transfer of a display, called by the display
+	@param oled display
+	@return false if the display was not added, it then sends blocking
+*/
+bool OLEDBusScheduler::startTransfer(SSD1306 &oled)
+{
+	for (uint8_t i = 0; i < _count; i++)
+	{
+		if (_displays[i].pOled != &oled) continue;
+		_displays[i].queued = true;
+		service();
+		return true;
+	}
+	return false;
+}
+
+/*!
+	@brief Moves queued transfers on while a display waits for its own
+*/
+void OLEDBusScheduler::serviceTransfer(void)
+{
+	service();
+}
+
+/*!
+	@brief Waits for the chunk on the bus of a display , called by the display
+	@param oled display about to send a blocking transaction
+*/
+void OLEDBusScheduler::waitBusFree(SSD1306 &oled)
+{
+	waitBus(oled.OLEDGetI2C());
+}
+
+/*!
+	@brief Waits for the chunk in progress on a bus, no new chunk is started
+	@param i2c i2c0 or i2c1
+	@note Call before accessing another device on the bus, then call service
+		from the same core after it so no chunk starts in between.
+*/
+void OLEDBusScheduler::waitBus(i2c_inst *i2c)
+{
+	uint8_t bus = i2c_hw_index(i2c);
+	if (!_lanes[bus].open) return;
+	while (!laneDone(bus)) tight_loop_contents();
+}
+
+/*!
+	@brief Starts the next chunk on each bus that is free
+	@return true while any bus is busy or a display waits
+*/
+bool OLEDBusScheduler::service(void)
+{
+	bool busy = false;
+	for (uint8_t bus = 0; bus < OLED_BUS_COUNT; bus++)
+	{
+		if (!_lanes[bus].open) continue;
+		if (laneDone(bus)) startChunk(bus);
+		if (_lanes[bus].active >= 0) busy = true;
+	}
+	return busy;
+}
+
+/*!
+	@brief Calls service until every queued update is sent
+*/
+void OLEDBusScheduler::waitIdle(void)
+{
+	while (service()) tight_loop_contents();
+}
+
+/*!
+	@brief Checks if all buses are free and no display waits
+	@return true when idle
+*/
+bool OLEDBusScheduler::isIdle(void) const
+{
+	for (uint8_t bus = 0; bus < OLED_BUS_COUNT; bus++)
+		if (_lanes[bus].active >= 0) return false;
+	for (uint8_t i = 0; i < _count; i++)
+		if (_displays[i].queued) return false;
+	return true;
+}
+
+/*!
+	@brief Gets the bytes sent on one bus
+	@param bus 0 for i2c0, 1 for i2c1
+	@return byte count including control bytes
+*/
+uint32_t OLEDBusScheduler::bytesSent(uint8_t bus) const
+{
+	return (bus < OLED_BUS_COUNT) ? _lanes[bus].bytes : 0;
+}
+
+/*!
+	@brief Gets the number of chunks the controllers aborted
+	@return count, the transfer of the display was ended each time
+*/
+uint32_t OLEDBusScheduler::aborts(void) const {return _aborts;}
+
+/*!
+	@brief Checks if the chunk on a bus is finished , used internally
+	@param bus controller index
+	@return true if the bus is free for the next chunk
+	@details A chunk is finished when DMA has fed all words, the FIFO is empty
+		and the controller is idle after the STOP. On host builds the chunk
+		was written blocking when it started.
+*/
+bool OLEDBusScheduler::laneDone(uint8_t bus)
+{
+	OLEDBusLane_t &lane = _lanes[bus];
+	if (lane.active < 0) return true;
+#if PICO_ON_DEVICE
+	i2c_hw_t *hw = i2c_get_hw(bus == 0 ? i2c0 : i2c1);
+	if (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS)
+	{
+		dma_channel_abort(lane.dmaChannel);
+		(void)hw->clr_tx_abrt;
+		OLEDBusDisplay_t &display = _displays[lane.active];
+		display.pOled->OLEDTxEnd();
+		display.queued = false;
+		OLEDReportError(OLED_TransferAbort, "bus laneDone 1");
+		_aborts++;
+		lane.active = -1;
+		return true;
+	}
+	if (dma_channel_is_busy(lane.dmaChannel)) return false;
+	uint32_t idle = hw->status & (I2C_IC_STATUS_TFE_BITS | I2C_IC_STATUS_ACTIVITY_BITS);
+	if (idle != I2C_IC_STATUS_TFE_BITS) return false;
+#endif
+	lane.active = -1;
+	return true;
+}
+
+/*!
+	@brief Picks the display served next on a bus , used internally
+	@param bus controller index
+	@return display index, -1 if none waits
+	@details Among equal priorities a display on the open multiplexer channel
+		wins until the bus held the channel OLED_BUS_MUX_HOLD chunks.
+*/
+int8_t OLEDBusScheduler::pickDisplay(uint8_t bus)
+{
+	OLEDBusLane_t &lane = _lanes[bus];
+	bool group = lane.held < OLED_BUS_MUX_HOLD;
+	int8_t best = -1;
+	for (uint8_t n = 0; n < _count; n++)
+	{
+		uint8_t i = (lane.turn + n) % _count; // equal priorities take turns
+		const OLEDBusDisplay_t &display = _displays[i];
+		if (display.bus != bus || !display.queued) continue;
+		if (best < 0 || display.priority > _displays[best].priority)
+			best = i;
+		else if (group && display.priority == _displays[best].priority &&
+			needsSwitch(_displays[best]) && !needsSwitch(display))
+			best = i;
+	}
+	if (best < 0) return best;
+	bool waiting = false; // another channel waits while this one is kept
+	for (uint8_t i = 0; i < _count; i++)
+		if (_displays[i].bus == bus && _displays[i].queued && needsSwitch(_displays[i])) waiting = true;
+	if (needsSwitch(_displays[best]) || !waiting)
+		lane.held = 0;
+	else if (lane.held < OLED_BUS_MUX_HOLD)
+		lane.held++;
+	return best;
+}
+
+/*!
+	@brief Checks if serving a display needs a multiplexer channel switch , used internally
+	@param display display to check
+	@return true if the display is behind a multiplexer with another channel open
+*/
+bool OLEDBusScheduler::needsSwitch(const OLEDBusDisplay_t &display) const
+{
+	OLEDI2CMux *pMux = display.pOled->OLEDGetMux();
+	return (pMux != nullptr) && (pMux->channel() != display.pOled->OLEDGetMuxChannel());
+}
+
+/*!
+	@brief Starts the next chunk of a waiting display , used internally
+	@param bus controller index, must be free
+*/
+void OLEDBusScheduler::startChunk(uint8_t bus)
+{
+	OLEDBusLane_t &lane = _lanes[bus];
+	OLEDTxSegment_t segment;
+	int8_t index;
+	while ((index = pickDisplay(bus)) >= 0)
+	{
+		OLEDBusDisplay_t &display = _displays[index];
+		if (display.pOled->OLEDTxNextSegment(segment, OLED_BUS_CHUNK)) break;
+		display.pOled->OLEDTxEnd();
+		display.queued = false;
+	}
+	if (index < 0) return;
+	if (needsSwitch(_displays[index]))
+	{
+		if (!_displays[index].pOled->OLEDMuxSelect())
+		{
+			_displays[index].pOled->OLEDTxEnd();
+			_displays[index].queued = false;
+			_aborts++;
+			return;
+		}
+	}
+	lane.active = index;
+	lane.turn = index + 1;
+	i2c_inst *i2c = _displays[index].pOled->OLEDGetI2C();
+
+#if PICO_ON_DEVICE
+	lane.words[0] = segment.control;
+	for (uint16_t i = 0; i < segment.length; i++)
+		lane.words[i + 1] = segment.pData[i];
+	lane.words[segment.length] |= I2C_IC_DATA_CMD_STOP_BITS;
+
+	i2c_hw_t *hw = i2c_get_hw(i2c);
+	// blocking writes to any device on the bus set the target too, set it every chunk
+	hw->enable = 0;
+	hw->tar = _displays[index].pOled->OLEDGetAddress();
+	hw->enable = 1;
+
+	dma_channel_config config = dma_channel_get_default_config(lane.dmaChannel);
+	channel_config_set_transfer_data_size(&config, DMA_SIZE_16);
+	channel_config_set_read_increment(&config, true);
+	channel_config_set_write_increment(&config, false);
+	channel_config_set_dreq(&config, i2c_get_dreq(i2c, true));
+	dma_channel_configure(lane.dmaChannel, &config, &hw->data_cmd, lane.words, segment.length + 1, true);
+#else
+	lane.frame[0] = segment.control;
+	memcpy(&lane.frame[1], segment.pData, segment.length);
+	int sent = i2c_write_blocking(i2c, _displays[index].pOled->OLEDGetAddress(), lane.frame, segment.length + 1, false);
+	if (sent != segment.length + 1)
+	{
+		_displays[index].pOled->OLEDTxEnd();
+		_displays[index].queued = false;
+		OLEDReportError(OLED_TransferAbort, "bus startChunk 1");
+		_aborts++;
+		lane.active = -1;
+		return;
+	}
+#endif
+	lane.bytes += segment.length + 1;
+}
@@ -0,0 +1,105 @@
+/*!
+	@file ssd1306_oled_bus.h
+	@brief OLED driven by SSD1306 controller. header file
+		for the multi display bus scheduler.
+	@details Owns the I2C transport of several displays on i2c0 and i2c1.
+		Updates of the displays are queued and sent in chunks, one chunk per
+		bus at a time, taken from the displays fairly or by priority. Each
+		chunk is fed to the controller by DMA, so both buses send at the same
+		time while the CPU only picks the next chunk. Host builds send each
+		chunk with a blocking write instead, so the scheduling runs against
+		the emulator in host/.
+*/
+
+#pragma once
+
+#include "ssd1306_oled.h"
+#if PICO_ON_DEVICE
+#include "hardware/dma.h"
+#endif
+
+#ifndef OLED_BUS_MAX_DISPLAYS
+#define OLED_BUS_MAX_DISPLAYS 4 /**< Displays handled by one scheduler */
+#endif
+#ifndef OLED_BUS_CHUNK
+#define OLED_BUS_CHUNK 128 /**< Max data bytes per chunk, one page of a 128 wide panel */
+#endif
+#ifndef OLED_BUS_MUX_HOLD
+#define OLED_BUS_MUX_HOLD 16 /**< Chunks a bus stays on one multiplexer channel while another waits */
+#endif
+#define OLED_BUS_COUNT 2 /**< I2C controllers of the RP2040 */
+
+/*!
+	@brief class to schedule display updates over both I2C buses with DMA
+	@details Add the displays, then call OLEDupdate or OLEDupdateDirty on them
+		as usual, they return at once. Call service often, it starts the next
+		chunk on every bus that finished its last one.
+	@note Displays with a higher priority are served first, equal priorities
+		take turns chunk by chunk. Command writes and stepped updates of the
+		displays wait for the chunk on their bus. Call waitBus before using
+		other devices on a bus. Behind a multiplexer the displays on the
+		open channel go first, so a channel switch costs one write per
+		OLED_BUS_MUX_HOLD chunks at most, not one per chunk. service must be
+		called on the core that uses the displays.
+	@warning A transfer ends only in service. OLEDIsBusy of a display stays
+		true after its last chunk left the bus until service or OLEDWaitIdle
+		runs again, so a loop that polls OLEDIsBusy without calling service
+		never ends. Call service in the loop, or use OLEDWaitIdle or waitIdle.
+*/
+class OLEDBusScheduler : public OLEDTxTransport
+{
+  public:
+	OLEDBusScheduler(){};
+
+	bool addDisplay(SSD1306 &oled, uint8_t priority = 0);
+	void end(void);
+	bool service(void);
+	void waitIdle(void);
+	bool isIdle(void) const;
+	uint32_t bytesSent(uint8_t bus) const;
+	uint32_t aborts(void) const;
+	void waitBus(i2c_inst *i2c);
+
+	virtual bool startTransfer(SSD1306 &oled) override;
+	virtual void serviceTransfer(void) override;
+	virtual void waitBusFree(SSD1306 &oled) override;
+
+  private:
+
+	/*! @brief one display served by the scheduler */
+	struct OLEDBusDisplay_t
+	{
+		SSD1306 *pOled;     /**< Display */
+		uint8_t bus;        /**< I2C controller index */
+		uint8_t priority;   /**< Higher is served first */
+		bool queued;        /**< Has a transfer waiting or in progress */
+	};
+
+	/*! @brief state of one I2C controller */
+	struct OLEDBusLane_t
+	{
+		bool open = false;      /**< A display was added on this bus */
+#if PICO_ON_DEVICE
+		int dmaChannel = -1;    /**< DMA channel feeding the TX FIFO, -1 unclaimed */
+#endif
+		int8_t active = -1;     /**< Display whose chunk is on the bus, -1 idle */
+		uint8_t turn = 0;       /**< Display after the one served last */
+		uint8_t held = 0;       /**< Chunks sent on the open multiplexer channel while another waits */
+		uint32_t bytes = 0;     /**< Bytes sent including control bytes */
+#if PICO_ON_DEVICE
+		uint16_t words[OLED_BUS_CHUNK + 1]; /**< Data command words of the chunk */
+#else
+		uint8_t frame[OLED_BUS_CHUNK + 1];  /**< Control byte and data of the chunk */
+#endif
+	};
+
+	bool laneDone(uint8_t bus);
+	void startChunk(uint8_t bus);
+	int8_t pickDisplay(uint8_t bus);
+	bool needsSwitch(const OLEDBusDisplay_t &display) const;
+
+	OLEDBusDisplay_t _displays[OLED_BUS_MAX_DISPLAYS]; /**< Displays served */
+	uint8_t _count = 0;                /**< Number of displays */
+	OLEDBusLane_t _lanes[OLED_BUS_COUNT]; /**< One per I2C controller */
+	uint32_t _aborts = 0;              /**< Chunks aborted by the controller */
+};
@@ -0,0 +1,253 @@
+/*!
+	@file ssd1306_oled_canvas.cpp
+	@brief OLED driven by SSD1306 controller. Source file
+		for the tiled multi display canvas.
+*/
+
+#include "ssd1306_oled_canvas.h"
+
+/*!
+	@brief Constructor for the canvas
+	@param width width of the whole canvas in pixels
+	@param height height of the whole canvas in pixels
+	@param tileWidth width of one module in pixels
+	@param tileHeight height of one module in pixels
+	@note At most OLED_CANVAS_MAX_TILES tiles, extra tiles can not be set.
+*/
+OLEDCanvas::OLEDCanvas(int16_t width, int16_t height, uint8_t tileWidth, uint8_t tileHeight) :
+	SSD1306_graphics(width, height), _tileWidth(tileWidth), _tileHeight(tileHeight)
+{
+	_columns = (tileWidth == 0) ? 0 : (width + tileWidth - 1) / tileWidth;
+	_rows = (tileHeight == 0) ? 0 : (height + tileHeight - 1) / tileHeight;
+	for (uint8_t i = 0; i < OLED_CANVAS_MAX_TILES; i++)
+	{
+		_tiles[i].pOled = nullptr;
+		_tiles[i].x0 = 0xFF;
+		_tiles[i].x1 = 0;
+		_tiles[i].y0 = 0xFF;
+		_tiles[i].y1 = 0;
+	}
+}
+
+/*!
+	@brief Sets the display showing one tile of the canvas
+	@param column tile column , 0 is the left
+	@param row tile row , 0 is the top
+	@param oled display with its buffer set , rotation 0
+	@return false if the tile is off the grid or the display is not the tile size
+*/
+bool OLEDCanvas::setTile(uint8_t column, uint8_t row, SSD1306 &oled)
+{
+	uint16_t index = row * _columns + column;
+	if (column >= _columns || row >= _rows || index >= OLED_CANVAS_MAX_TILES) return false;
+	if (oled.OLEDGetBufferPtr() == nullptr || oled.getRotation() != OLED_Degrees_0) return false;
+	if (oled.width() != _tileWidth || oled.height() != _tileHeight) return false;
+	_tiles[index].pOled = &oled;
+	touch(_tiles[index], 0, 0, _tileWidth - 1, _tileHeight - 1);
+	return true;
+}
+
+/*!
+	@brief Gets the display showing one tile
+	@param column tile column
+	@param row tile row
+	@return the display , nullptr if none is set
+*/
+SSD1306* OLEDCanvas::getTile(uint8_t column, uint8_t row) const
+{
+	uint16_t index = row * _columns + column;
+	if (column >= _columns || row >= _rows || index >= OLED_CANVAS_MAX_TILES) return nullptr;
+	return _tiles[index].pOled;
+}
+
+/*! @brief Gets the number of tiles across the canvas @return tile columns */
+uint8_t OLEDCanvas::columns(void) const {return _columns;}
+
+/*! @brief Gets the number of tiles down the canvas @return tile rows */
+uint8_t OLEDCanvas::rows(void) const {return _rows;}
+
+/*!
+	@brief Grows the touched area of a tile , used internally
+	@param tile tile to grow
+	@param x0 left column
+	@param y0 top row
+	@param x1 right column
+	@param y1 bottom row
+*/
+void OLEDCanvas::touch(OLEDCanvasTile_t &tile, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1)
+{
+	if (x0 < tile.x0) tile.x0 = x0;
+	if (x1 > tile.x1) tile.x1 = x1;
+	if (y0 < tile.y0) tile.y0 = y0;
+	if (y1 > tile.y1) tile.y1 = y1;
+}
+
+/*!
+	@brief Draws a pixel on the tile under it
+	@param x x coordinate
+	@param y y coordinate
+	@param color WHITE BLACK or INVERSE
+*/
+void OLEDCanvas::drawPixel(int16_t x, int16_t y, uint8_t color)
+{
+	if ((x < 0) || (x >= _width) || (y < 0) || (y >= _height)) return;
+	if ((x < _clipX0) || (x >= _clipX1) || (y < _clipY0) || (y >= _clipY1)) return;
+
+	int16_t temp;
+	switch (getRotation())
+	{
+	case 1:
+		temp = x;
+		x = WIDTH - 1 - y;
+		y = temp;
+	break;
+	case 2:
+		x = WIDTH - 1 - x;
+		y = HEIGHT - 1 - y;
+	break;
+	case 3:
+		temp = x;
+		x = y;
+		y = HEIGHT - 1 - temp;
+	break;
+	default: break;
+	}
+
+	uint8_t column = x / _tileWidth;
+	uint8_t row = y / _tileHeight;
+	uint16_t index = row * _columns + column;
+	if (index >= OLED_CANVAS_MAX_TILES || _tiles[index].pOled == nullptr) return;
+
+	uint8_t tx = x - column * _tileWidth;
+	uint8_t ty = y - row * _tileHeight;
+	_tiles[index].pOled->drawPixel(tx, ty, color);
+	touch(_tiles[index], tx, ty, tx, ty);
+}
+
+/*!
+	@brief Marks an area of the canvas to be sent by the next flush
+	@param x x start coordinate
+	@param y y start coordinate
+	@param w width of the area
+	@param h height of the area
+	@details Drawing marks what it touches, this is for buffers changed
+		directly through the tile displays.
+*/
+void OLEDCanvas::markDirty(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+	if (w <= 0 || h <= 0) return;
+	int16_t rx = x, ry = y, rw = w, rh = h;
+	switch (getRotation())
+	{
+	case 1:
+		rx = WIDTH - y - h; ry = x; rw = h; rh = w;
+	break;
+	case 2:
+		rx = WIDTH - x - w; ry = HEIGHT - y - h;
+	break;
+	case 3:
+		rx = y; ry = HEIGHT - x - w; rw = h; rh = w;
+	break;
+	default: break;
+	}
+	int16_t x1 = rx + rw - 1, y1 = ry + rh - 1;
+	if (rx < 0) rx = 0;
+	if (ry < 0) ry = 0;
+	if (x1 >= WIDTH) x1 = WIDTH - 1;
+	if (y1 >= HEIGHT) y1 = HEIGHT - 1;
+	if (rx > x1 || ry > y1) return;
+
+	for (uint8_t row = ry / _tileHeight; row <= y1 / _tileHeight; row++)
+	{
+		for (uint8_t column = rx / _tileWidth; column <= x1 / _tileWidth; column++)
+		{
+			uint16_t index = row * _columns + column;
+			if (index >= OLED_CANVAS_MAX_TILES || _tiles[index].pOled == nullptr) continue;
+			int16_t left = column * _tileWidth, top = row * _tileHeight;
+			int16_t tx0 = (rx > left) ? rx - left : 0;
+			int16_t ty0 = (ry > top) ? ry - top : 0;
+			int16_t tx1 = (x1 < left + _tileWidth - 1) ? x1 - left : _tileWidth - 1;
+			int16_t ty1 = (y1 < top + _tileHeight - 1) ? y1 - top : _tileHeight - 1;
+			touch(_tiles[index], tx0, ty0, tx1, ty1);
+		}
+	}
+}
+
+/*!
+	@brief Clears the buffers of all tiles , every tile is sent by the next flush
+*/
+void OLEDCanvas::clearBuffer(void)
+{
+	for (uint8_t i = 0; i < OLED_CANVAS_MAX_TILES; i++)
+	{
+		if (_tiles[i].pOled == nullptr) continue;
+		_tiles[i].pOled->OLEDclearBuffer();
+		touch(_tiles[i], 0, 0, _tileWidth - 1, _tileHeight - 1);
+	}
+}
+
+/*!
+	@brief Sends the touched area of every touched tile
+	@return number of tiles sent
+	@details Each tile goes out with OLEDupdateDirty of its display, so tiles
+		with a background transport are only started, call waitIdle to finish.
+		Untouched tiles cost nothing.
+*/
+uint8_t OLEDCanvas::flush(void)
+{
+	uint8_t sent = 0;
+	for (uint8_t i = 0; i < OLED_CANVAS_MAX_TILES; i++)
+	{
+		OLEDCanvasTile_t &tile = _tiles[i];
+		if (tile.pOled == nullptr || tile.x0 > tile.x1) continue;
+		tile.pOled->markDirty(tile.x0, tile.y0, tile.x1 - tile.x0 + 1, tile.y1 - tile.y0 + 1);
+		tile.pOled->OLEDupdateDirty();
+		tile.x0 = 0xFF;
+		tile.x1 = 0;
+		tile.y0 = 0xFF;
+		tile.y1 = 0;
+		sent++;
+	}
+	return sent;
+}
+
+/*!
+	@brief Sends every tile in full
+*/
+void OLEDCanvas::flushAll(void)
+{
+	for (uint8_t i = 0; i < OLED_CANVAS_MAX_TILES; i++)
+	{
+		OLEDCanvasTile_t &tile = _tiles[i];
+		if (tile.pOled == nullptr) continue;
+		tile.pOled->OLEDupdate();
+		tile.x0 = 0xFF;
+		tile.x1 = 0;
+		tile.y0 = 0xFF;
+		tile.y1 = 0;
+	}
+}
+
+/*!
+	@brief Waits for the transfers of all tiles to finish
+*/
+void OLEDCanvas::waitIdle(void)
+{
+	for (uint8_t i = 0; i < OLED_CANVAS_MAX_TILES; i++)
+	{
+		if (_tiles[i].pOled != nullptr) _tiles[i].pOled->OLEDWaitIdle();
+	}
+}
+
+/*!
+	@brief Checks if a tile has been touched since its last flush
+	@param column tile column
+	@param row tile row
+	@return true if the next flush sends the tile
+*/
+bool OLEDCanvas::isTileDirty(uint8_t column, uint8_t row) const
+{
+	uint16_t index = row * _columns + column;
+	if (column >= _columns || row >= _rows || index >= OLED_CANVAS_MAX_TILES) return false;
+	return _tiles[index].pOled != nullptr && _tiles[index].x0 <= _tiles[index].x1;
+}
@@ -0,0 +1,67 @@
+/*!
+	@file ssd1306_oled_canvas.h
+	@brief OLED driven by SSD1306 controller. header file
+		for the tiled multi display canvas.
+	@details One drawing surface spread over a grid of displays, for panels
+		built from several modules such as 256x64 or 256x128 from 128x64
+		modules. The canvas may be wider or taller than 255 pixels. Each
+		draw lands in the buffer of the display under it and grows the touched
+		area of that tile, a flush sends only the touched tiles.
+*/
+
+#pragma once
+
+#include "ssd1306_oled.h"
+
+#ifndef OLED_CANVAS_MAX_TILES
+#define OLED_CANVAS_MAX_TILES 4 /**< Displays held by one OLEDCanvas */
+#endif
+
+/*!
+	@brief class for a drawing surface made of a grid of SSD1306 displays
+	@details Give each tile a display with its buffer set, draw on the canvas
+		with the usual graphics functions, then call flush. Tile (0,0) is the
+		top left module, columns run left to right and rows top to bottom.
+	@note The tile displays stay at rotation 0 , rotate the canvas instead.
+		With the displays added to an OLEDBusScheduler flush returns at once
+		and the tiles on i2c0 and i2c1 are sent at the same time.
+*/
+class OLEDCanvas : public SSD1306_graphics
+{
+  public:
+	OLEDCanvas(int16_t width, int16_t height, uint8_t tileWidth = 128, uint8_t tileHeight = 64);
+
+	bool setTile(uint8_t column, uint8_t row, SSD1306 &oled);
+	SSD1306* getTile(uint8_t column, uint8_t row) const;
+	uint8_t columns(void) const;
+	uint8_t rows(void) const;
+
+	virtual void drawPixel(int16_t x, int16_t y, uint8_t color) override;
+	virtual void markDirty(int16_t x, int16_t y, int16_t w, int16_t h) override;
+	void clearBuffer(void);
+
+	uint8_t flush(void);
+	void flushAll(void);
+	void waitIdle(void);
+	bool isTileDirty(uint8_t column, uint8_t row) const;
+
+  private:
+
+	/*! @brief one module of the canvas and the area touched since its last flush */
+	struct OLEDCanvasTile_t
+	{
+		SSD1306* pOled; /**< Display showing the tile , nullptr = none */
+		uint8_t x0;     /**< Left touched column , 0xFF = clean */
+		uint8_t x1;     /**< Right touched column */
+		uint8_t y0;     /**< Top touched row */
+		uint8_t y1;     /**< Bottom touched row */
+	};
+
+	void touch(OLEDCanvasTile_t &tile, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1);
+
+	OLEDCanvasTile_t _tiles[OLED_CANVAS_MAX_TILES]; /**< Tiles , row by row */
+	uint8_t _tileWidth;  /**< Width of one module in pixels */
+	uint8_t _tileHeight; /**< Height of one module in pixels */
+	uint8_t _columns;    /**< Tiles across the canvas */
+	uint8_t _rows;       /**< Tiles down the canvas */
+};
@@ -0,0 +1,223 @@
+/*!
+	@file ssd1306_oled_console.cpp
+	@brief OLED driven by SSD1306 controller. Source file
+		for the text console.
+*/
+
+#include "ssd1306_oled_console.h"
+
+/*!
+	@brief Starts the console with the current font of the display
+	@param pCells character cell buffer, holds columns() characters per line
+	@param sizeOfCells size of buffer, lines held = sizeOfCells / columns
+	@return true for success, false if the font is not 1-6 or the buffer
+		does not hold at least one line more than the screen shows.
+	@note Clears the screen. Font 1 at 128 pixels wide is 21 columns,
+		e.g. a 21 * 32 buffer gives 23 lines of scrollback on 128x64.
+		The extra line is the one being written, it never shares a
+		ring slot with a visible row.
+*/
+bool OLEDConsole::begin(char* pCells, uint16_t sizeOfCells)
+{
+	if (_oled.getFontNum() >= OLEDFont_Bignum)
+	{
+		OLED_ERROR(OLED_WrongFont, "console begin 1", "Wrong font selected, must be font 1-6: %u\r\n", OLED_WrongFont);
+		return false;
+	}
+	_fontNumber = _oled.getFontNum();
+	_glyphWidth = (_oled.getCharAdvance() / _oled.getTextSize()) - 1;
+	_width = _oled.width();
+	_pages = _oled.height() / 8;
+	_columns = _width / (_glyphWidth + 1);
+	_rows = sizeOfCells / _columns;
+	if (pCells == nullptr || _rows <= _pages)
+	{
+		OLED_ERROR(OLED_BufferSize, "console begin 2", "Cell buffer must hold at least %u lines of %u characters\r\n", _pages + 1, _columns);
+		_pCells = nullptr;
+		return false;
+	}
+	_pCells = pCells;
+	clear();
+	return true;
+}
+
+/*!
+	@brief Stops the console and resets the display start line
+	@note Call OLEDupdate afterwards to show the frame buffer again.
+*/
+void OLEDConsole::end(void)
+{
+	_oled.OLEDSetStartLine(0);
+	_startLine = 0;
+	_pCells = nullptr;
+}
+
+/*!
+	@brief Clears the screen, the current line and the scrollback
+*/
+void OLEDConsole::clear(void)
+{
+	if (_pCells == nullptr) return;
+	memset(_pCells, ' ', _rows * _columns);
+	_line = 0;
+	_column = 0;
+	_doneShown = 0;
+	_scrollBack = 0;
+	_startLine = 0xFF;
+	renderLines(0, _pages - 1);
+}
+
+/*!
+	@brief Shows the current, not yet completed, line
+	@note Completed lines are shown by write, a partial line only by flush.
+*/
+void OLEDConsole::flush(void)
+{
+	if (_pCells == nullptr || _scrollBack != 0) return;
+	renderLines(_line, _line);
+}
+
+/*!
+	@brief Writes a character to the console
+	@param character ASCII character , '\n' ends the line
+	@return 1 for success
+*/
+size_t OLEDConsole::write(uint8_t character)
+{
+	return write(&character, 1);
+}
+
+/*!
+	@brief Writes a run of characters to the console
+	@param buffer characters to write
+	@param size number of characters
+	@return number of characters consumed
+	@details Cells are updated first, then every line completed by a '\n' or
+		a wrap is rendered once and the start line moved. A println of any
+		length costs one page, the print calls that build the line cost none.
+		While scrolled back nothing is sent until the view returns to live.
+*/
+size_t OLEDConsole::write(const uint8_t *buffer, size_t size)
+{
+	if (_pCells == nullptr || buffer == nullptr) return 0;
+
+	for (size_t n = 0; n < size; n++)
+	{
+		uint8_t character = buffer[n];
+		if (character == '\r') continue;
+		if (character == '\n' || _column >= _columns)
+		{
+			_line++;
+			_column = 0;
+			memset(rowCells(_line), ' ', _columns);
+			if (character == '\n') continue;
+		}
+		rowCells(_line)[_column++] = character;
+	}
+
+	if (_scrollBack == 0 && _line > _doneShown)
+	{
+		uint32_t first = _doneShown;
+		if (_line > _pages && first < _line - _pages) first = _line - _pages;
+		renderLines(first, _line - 1);
+		_doneShown = _line;
+	}
+	return size;
+}
+
+/*!
+	@brief Views older lines
+	@param lines number of lines to scroll back from the newest completed line,
+		0 returns to live view
+	@note Redraws the visible rows, capped at scrollBackMax().
+*/
+void OLEDConsole::scrollBack(uint16_t lines)
+{
+	if (_pCells == nullptr) return;
+	if (lines > scrollBackMax()) lines = scrollBackMax();
+	if (lines == _scrollBack) return;
+	_scrollBack = lines;
+	renderView();
+}
+
+/*!
+	@brief Gets how far the console can scroll back
+	@return completed lines held in the ring buffer beyond the visible ones
+*/
+uint16_t OLEDConsole::scrollBackMax(void) const
+{
+	uint32_t held = (_line < (uint32_t)(_rows - 1)) ? _line : (_rows - 1);
+	return (held > _pages) ? (held - _pages) : 0;
+}
+
+/*!
+	@brief Gets the number of characters per line
+	@return columns
+*/
+uint8_t OLEDConsole::columns(void) const {return _columns;}
+
+/*!
+	@brief Gets the number of lines held in the cell buffer
+	@return rows, visible plus scrollback
+*/
+uint16_t OLEDConsole::rows(void) const {return _rows;}
+
+/*!
+	@brief Gets the cells of a line in the ring buffer , used internally
+	@param line absolute line number
+	@return pointer to columns() characters
+*/
+char* OLEDConsole::rowCells(uint32_t line) const
+{
+	return _pCells + ((line % _rows) * _columns);
+}
+
+/*!
+	@brief Redraws every visible line of the current view , used internally
+*/
+void OLEDConsole::renderView(void)
+{
+	uint32_t newest = (_line > 0) ? (_line - 1 - _scrollBack) : 0;
+	uint32_t first = (newest >= _pages) ? (newest - _pages + 1) : 0;
+	renderLines(first, (newest < (uint32_t)(_pages - 1)) ? (_pages - 1) : newest);
+	if (_scrollBack == 0) _doneShown = _line;
+}
+
+/*!
+	@brief Renders lines to their display RAM pages and scrolls them into view , used internally
+	@param first oldest line to render
+	@param last newest line to render, becomes the bottom row of the screen
+	@details Line n lives in RAM page n % 8, so the view of the newest lines is
+		always a contiguous run of pages and the start line selects it.
+*/
+void OLEDConsole::renderLines(uint32_t first, uint32_t last)
+{
+	uint8_t row[128];
+	uint8_t oldFont = _oled.getFontNum();
+	if (oldFont != _fontNumber) _oled.setFontNum((OLEDFontType_e)_fontNumber);
+
+	for (uint32_t line = first; line <= last; line++)
+	{
+		const char* cells = rowCells(line);
+		memset(row, 0x00, _width);
+		for (uint8_t column = 0; column < _columns; column++)
+		{
+			const uint8_t* pGlyph = _oled.getGlyph(cells[column]);
+			if (pGlyph != nullptr)
+				memcpy(&row[column * (_glyphWidth + 1)], pGlyph, _glyphWidth);
+		}
+		uint8_t page = line % SSD1306_GDDRAM_PAGES;
+		_oled.OLEDSetWindow(0, _width - 1, page, page);
+		_oled.OLEDWriteData(row, _width);
+	}
+
+	if (oldFont != _fontNumber) _oled.setFontNum((OLEDFontType_e)oldFont);
+
+	uint32_t top = (last >= _pages) ? (last - _pages + 1) : 0;
+	uint8_t startLine = (top % SSD1306_GDDRAM_PAGES) * 8;
+	if (startLine != _startLine)
+	{
+		_oled.OLEDSetStartLine(startLine);
+		_startLine = startLine;
+	}
+}
@@ -0,0 +1,59 @@
+/*!
+	@file ssd1306_oled_console.h
+	@brief OLED driven by SSD1306 controller. header file
+		for the text console.
+	@details Scrolling log console. Lines are held in a character cell ring
+		buffer with scrollback. Each text row is one display RAM page, the
+		picture scrolls with the start line register so a completed line costs
+		one page of I2C data and one command, the screen is never redrawn.
+*/
+
+#pragma once
+
+#include "ssd1306_oled.h"
+
+/*!
+	@brief class for a scrolling text console on a SSD1306 display
+	@note Uses fonts 1-6 at text size 1 and screen rotation 0.
+		The console owns the display RAM while active, call end() before
+		using OLEDupdate again.
+*/
+class OLEDConsole : public Print
+{
+  public:
+	OLEDConsole(SSD1306 &oled) : _oled(oled) {};
+
+	bool begin(char* pCells, uint16_t sizeOfCells);
+	void end(void);
+	void clear(void);
+	void flush(void);
+
+	using Print::write;
+	virtual size_t write(uint8_t character) override;
+	virtual size_t write(const uint8_t *buffer, size_t size) override;
+
+	void scrollBack(uint16_t lines);
+	uint16_t scrollBackMax(void) const;
+	uint8_t columns(void) const;
+	uint16_t rows(void) const;
+
+  private:
+
+	char* rowCells(uint32_t line) const;
+	void renderLines(uint32_t first, uint32_t last);
+	void renderView(void);
+
+	SSD1306 &_oled;                 /**< Display the console draws on */
+	char* _pCells = nullptr;        /**< Character cell ring buffer, rows * columns */
+	uint16_t _rows = 0;             /**< Number of lines held, visible plus scrollback */
+	uint8_t _columns = 0;           /**< Characters per line */
+	uint8_t _pages = 0;             /**< Visible text rows, one per page */
+	uint8_t _width = 0;             /**< Width of display in pixels */
+	uint8_t _fontNumber = 1;        /**< Font at begin, 1-6 */
+	uint8_t _glyphWidth = 5;        /**< Glyph width of font in pixels, without padding */
+	uint8_t _startLine = 0;         /**< Current display start line */
+	uint32_t _line = 0;             /**< Absolute number of the line being written */
+	uint32_t _doneShown = 0;        /**< Number of completed lines rendered to display RAM */
+	uint8_t _column = 0;            /**< Cursor column on the current line */
+	uint16_t _scrollBack = 0;       /**< Lines scrolled back from the newest, 0 = live */
+};
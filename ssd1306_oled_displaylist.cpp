@@ -0,0 +1,542 @@
+/*!
+	@file ssd1306_oled_displaylist.cpp
+	@brief OLED driven by SSD1306 controller. Source file
+		for the display list functions.
+*/
+
+#include "ssd1306_oled_displaylist.h"
+
+// True if two rectangles share at least one pixel
+static inline bool OLEDRectOverlap(const OLEDRect_t &a, const OLEDRect_t &b)
+{
+	return a.w > 0 && a.h > 0 && b.w > 0 && b.h > 0 &&
+		a.x < b.x + b.w && b.x < a.x + a.w &&
+		a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+/*!
+	@brief Sets the arena the ops are recorded into and empties the list
+	@param pOps pointer to array of op records
+	@param maxOps number of records in the array
+	@return true for success, false if the array is not valid
+*/
+bool OLEDDisplayList::begin(OLEDDrawOp_t *pOps, uint16_t maxOps)
+{
+	if (pOps == nullptr || maxOps == 0)
+	{
+		OLED_ERROR(OLED_BufferNullptr, "displaylist begin 1", "Op array is not valid pointer or has no records\r\n");
+		return false;
+	}
+	_pOps = pOps;
+	_maxOps = maxOps;
+	clear();
+	return true;
+}
+
+/*!
+	@brief Removes all ops, the arena is kept
+*/
+void OLEDDisplayList::clear(void)
+{
+	_count = 0;
+	_overflow = false;
+}
+
+/*!
+	@brief Gets the number of recorded ops
+	@return op count
+*/
+uint16_t OLEDDisplayList::size(void) const {return _count;}
+
+/*!
+	@brief Gets the number of op records in the arena
+	@return maximum op count
+*/
+uint16_t OLEDDisplayList::capacity(void) const {return _maxOps;}
+
+/*!
+	@brief Checks if ops were dropped since the last clear
+	@return true if the arena ran out of records
+*/
+bool OLEDDisplayList::overflowed(void) const {return _overflow;}
+
+/*!
+	@brief Gets the area covered by all recorded ops
+	@return bounding rectangle, w and h are 0 for an empty list
+*/
+OLEDRect_t OLEDDisplayList::bounds(void) const
+{
+	int16_t x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+	bool any = false;
+	for (uint16_t i = 0; i < _count; i++)
+	{
+		const OLEDRect_t &box = _pOps[i].box;
+		if (box.w <= 0 || box.h <= 0) continue;
+		if (!any || box.x < x0) x0 = box.x;
+		if (!any || box.y < y0) y0 = box.y;
+		if (!any || box.x + box.w > x1) x1 = box.x + box.w;
+		if (!any || box.y + box.h > y1) y1 = box.y + box.h;
+		any = true;
+	}
+	return OLEDRect_t{x0, y0, (int16_t)(x1 - x0), (int16_t)(y1 - y0)};
+}
+
+/*!
+	@brief Records a pixel
+	@param x x coordinate
+	@param y y coordinate
+	@param color color of pixel
+	@return false if the arena is full
+*/
+bool OLEDDisplayList::drawPixel(int16_t x, int16_t y, uint8_t color)
+{
+	OLEDDrawOp_t *pOp = append(OLEDOp_Pixel, color, x, y, 1, 1);
+	if (pOp == nullptr) return false;
+	pOp->p[0] = x;
+	pOp->p[1] = y;
+	return true;
+}
+
+/*!
+	@brief Records a line
+	@param x0 start x coordinate
+	@param y0 start y coordinate
+	@param x1 end x coordinate
+	@param y1 end y coordinate
+	@param color color of line
+	@return false if the arena is full
+*/
+bool OLEDDisplayList::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t color)
+{
+	int16_t left = (x0 < x1) ? x0 : x1;
+	int16_t top = (y0 < y1) ? y0 : y1;
+	OLEDDrawOp_t *pOp = append(OLEDOp_Line, color, left, top, abs(x1 - x0) + 1, abs(y1 - y0) + 1);
+	if (pOp == nullptr) return false;
+	pOp->p[0] = x0;
+	pOp->p[1] = y0;
+	pOp->p[2] = x1;
+	pOp->p[3] = y1;
+	return true;
+}
+
+/*!
+	@brief Records a rectangle outline
+	@param x x start coordinate
+	@param y y start coordinate
+	@param w width of the rectangle
+	@param h height of the rectangle
+	@param color color of rectangle
+	@return false if the arena is full
+*/
+bool OLEDDisplayList::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color)
+{
+	OLEDDrawOp_t *pOp = append(OLEDOp_Rect, color, x, y, w, h);
+	if (pOp == nullptr) return false;
+	pOp->p[0] = x;
+	pOp->p[1] = y;
+	pOp->p[2] = w;
+	pOp->p[3] = h;
+	return true;
+}
+
+/*!
+	@brief Records a filled rectangle
+	@param x x start coordinate
+	@param y y start coordinate
+	@param w width of the rectangle
+	@param h height of the rectangle
+	@param color color of rectangle
+	@return false if the arena is full
+*/
+bool OLEDDisplayList::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color)
+{
+	if (!drawRect(x, y, w, h, color)) return false;
+	_pOps[_count - 1].type = OLEDOp_FillRect;
+	return true;
+}
+
+/*!
+	@brief Records a circle outline
+	@param x0 circle center x position
+	@param y0 circle center y position
+	@param r radius of circle
+	@param color color of circle
+	@return false if the arena is full
+*/
+bool OLEDDisplayList::drawCircle(int16_t x0, int16_t y0, int16_t r, uint8_t color)
+{
+	OLEDDrawOp_t *pOp = append(OLEDOp_Circle, color, x0 - r, y0 - r, 2 * r + 1, 2 * r + 1);
+	if (pOp == nullptr) return false;
+	pOp->p[0] = x0;
+	pOp->p[1] = y0;
+	pOp->p[2] = r;
+	return true;
+}
+
+/*!
+	@brief Records a filled circle
+	@param x0 circle center x position
+	@param y0 circle center y position
+	@param r radius of circle
+	@param color color of circle
+	@return false if the arena is full
+*/
+bool OLEDDisplayList::fillCircle(int16_t x0, int16_t y0, int16_t r, uint8_t color)
+{
+	if (!drawCircle(x0, y0, r, color)) return false;
+	_pOps[_count - 1].type = OLEDOp_FillCircle;
+	return true;
+}
+
+/*!
+	@brief Records a rectangle outline with rounded corners
+	@param x x start coordinate
+	@param y y start coordinate
+	@param w width of the rectangle
+	@param h height of the rectangle
+	@param r radius of the rounded corners
+	@param color color of rectangle
+	@return false if the arena is full
+*/
+bool OLEDDisplayList::drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint8_t color)
+{
+	if (!drawRect(x, y, w, h, color)) return false;
+	_pOps[_count - 1].type = OLEDOp_RoundRect;
+	_pOps[_count - 1].p[4] = r;
+	return true;
+}
+
+/*!
+	@brief Records a filled rectangle with rounded corners
+	@param x x start coordinate
+	@param y y start coordinate
+	@param w width of the rectangle
+	@param h height of the rectangle
+	@param r radius of the rounded corners
+	@param color color of rectangle
+	@return false if the arena is full
+*/
+bool OLEDDisplayList::fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint8_t color)
+{
+	if (!drawRoundRect(x, y, w, h, r, color)) return false;
+	_pOps[_count - 1].type = OLEDOp_FillRoundRect;
+	return true;
+}
+
+/*!
+	@brief Records a triangle outline
+	@param x0 first corner x
+	@param y0 first corner y
+	@param x1 second corner x
+	@param y1 second corner y
+	@param x2 third corner x
+	@param y2 third corner y
+	@param color color of triangle
+	@return false if the arena is full
+*/
+bool OLEDDisplayList::drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+	int16_t x2, int16_t y2, uint8_t color)
+{
+	int16_t left = x0, right = x0, top = y0, bottom = y0;
+	if (x1 < left) left = x1;
+	if (x2 < left) left = x2;
+	if (x1 > right) right = x1;
+	if (x2 > right) right = x2;
+	if (y1 < top) top = y1;
+	if (y2 < top) top = y2;
+	if (y1 > bottom) bottom = y1;
+	if (y2 > bottom) bottom = y2;
+	OLEDDrawOp_t *pOp = append(OLEDOp_Triangle, color, left, top, right - left + 1, bottom - top + 1);
+	if (pOp == nullptr) return false;
+	pOp->p[0] = x0;
+	pOp->p[1] = y0;
+	pOp->p[2] = x1;
+	pOp->p[3] = y1;
+	pOp->p[4] = x2;
+	pOp->p[5] = y2;
+	return true;
+}
+
+/*!
+	@brief Records a filled triangle
+	@param x0 first corner x
+	@param y0 first corner y
+	@param x1 second corner x
+	@param y1 second corner y
+	@param x2 third corner x
+	@param y2 third corner y
+	@param color color of triangle
+	@return false if the arena is full
+*/
+bool OLEDDisplayList::fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+	int16_t x2, int16_t y2, uint8_t color)
+{
+	if (!drawTriangle(x0, y0, x1, y1, x2, y2, color)) return false;
+	_pOps[_count - 1].type = OLEDOp_FillTriangle;
+	return true;
+}
+
+/*!
+	@brief Records a string in the current font and text size of gfx
+	@param gfx graphics object supplying the font and its metrics
+	@param x X coordinate of first character
+	@param y Y coordinate
+	@param pText pointer to string of ASCII character's, must outlive the list
+	@param color text color
+	@param bg background color, equal to color draws a transparent background
+	@return false if the arena is full or pText is not valid
+	@note '\n' starts a new line at x.
+*/
+bool OLEDDisplayList::drawText(SSD1306_graphics &gfx, int16_t x, int16_t y, const char *pText,
+	uint8_t color, uint8_t bg)
+{
+	if (pText == nullptr)
+	{
+		OLED_ERROR(OLED_CharArrayNullptr, "displaylist drawText 1", "String array is not valid pointer: %u \n", OLED_CharArrayNullptr);
+		return false;
+	}
+	OLEDTextMetrics_t metrics = gfx.measureText(pText);
+	OLEDDrawOp_t *pOp = append(OLEDOp_Text, color, x, y, metrics.width, metrics.height);
+	if (pOp == nullptr) return false;
+	pOp->bg = bg;
+	pOp->font = gfx.getFontNum();
+	pOp->size = gfx.getTextSize();
+	pOp->p[0] = x;
+	pOp->p[1] = y;
+	pOp->pData = pText;
+	return true;
+}
+
+/*!
+	@brief Records a bitmap
+	@param x x start coordinate
+	@param y y start coordinate
+	@param w width of bitmap in pixels
+	@param h height of bitmap in pixels
+	@param pData horizontally addressed bitmap, rows of (w+7)/8 bytes MSB first, must outlive the list
+	@param color color of set bits
+	@param bg color of clear bits, equal to color leaves them untouched
+	@return false if the arena is full or pData is not valid
+*/
+bool OLEDDisplayList::drawBitmap(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t *pData,
+	uint8_t color, uint8_t bg)
+{
+	if (pData == nullptr)
+	{
+		OLED_ERROR(OLED_BitmapNullptr, "displaylist drawBitmap 1", "Bitmap is is not valid pointer\r\n");
+		return false;
+	}
+	OLEDDrawOp_t *pOp = append(OLEDOp_Bitmap, color, x, y, w, h);
+	if (pOp == nullptr) return false;
+	pOp->bg = bg;
+	pOp->p[0] = x;
+	pOp->p[1] = y;
+	pOp->p[2] = w;
+	pOp->p[3] = h;
+	pOp->pData = pData;
+	return true;
+}
+
+/*!
+	@brief Draws every op that touches the clip rectangle of gfx
+	@param gfx graphics object to draw on
+	@return number of ops drawn, the rest were culled
+*/
+uint16_t OLEDDisplayList::replay(SSD1306_graphics &gfx) const
+{
+	OLEDRect_t clip = gfx.getClipRect();
+	uint16_t drawn = 0;
+	for (uint16_t i = 0; i < _count; i++)
+	{
+		if (!OLEDRectOverlap(_pOps[i].box, clip)) continue;
+		drawOp(gfx, _pOps[i]);
+		drawn++;
+	}
+	return drawn;
+}
+
+/*!
+	@brief Draws the list into a rectangle only, such as a damaged area
+	@param gfx graphics object to draw on
+	@param x x start coordinate
+	@param y y start coordinate
+	@param w width of the area
+	@param h height of the area
+	@return number of ops drawn, the rest were culled
+	@note The area is intersected with the clip rectangle of gfx,
+		which is restored afterwards.
+*/
+uint16_t OLEDDisplayList::replay(SSD1306_graphics &gfx, int16_t x, int16_t y, int16_t w, int16_t h) const
+{
+	OLEDRect_t saved = gfx.getClipRect();
+	int16_t x0 = (x > saved.x) ? x : saved.x;
+	int16_t y0 = (y > saved.y) ? y : saved.y;
+	int16_t x1 = (x + w < saved.x + saved.w) ? x + w : saved.x + saved.w;
+	int16_t y1 = (y + h < saved.y + saved.h) ? y + h : saved.y + saved.h;
+	if (x1 <= x0 || y1 <= y0) return 0;
+
+	gfx.setClipRect(x0, y0, x1 - x0, y1 - y0);
+	uint16_t drawn = replay(gfx);
+	gfx.setClipRect(saved.x, saved.y, saved.w, saved.h);
+	return drawn;
+}
+
+/*!
+	@brief Draws the list into one band of 8 rows
+	@param gfx graphics object to draw on
+	@param page band number, rows page*8 to page*8+7
+	@return number of ops drawn, the rest were culled
+	@note Bands are in screen coordinates, at rotation 0 a band is one page
+		of the buffer.
+*/
+uint16_t OLEDDisplayList::replayPage(SSD1306_graphics &gfx, uint8_t page) const
+{
+	return replay(gfx, 0, page * 8, gfx.width(), 8);
+}
+
+/*!
+	@brief Marks the area of every op a replay on gfx would draw
+	@param gfx graphics object the list is drawn on
+	@details Each op box is cut to the clip rectangle of gfx and passed to
+		its markDirty, for OLEDupdateDirty after a replay.
+*/
+void OLEDDisplayList::markDirty(SSD1306_graphics &gfx) const
+{
+	OLEDRect_t clip = gfx.getClipRect();
+	for (uint16_t i = 0; i < _count; i++)
+	{
+		const OLEDRect_t &box = _pOps[i].box;
+		if (!OLEDRectOverlap(box, clip)) continue;
+		int16_t x0 = (box.x > clip.x) ? box.x : clip.x;
+		int16_t y0 = (box.y > clip.y) ? box.y : clip.y;
+		int16_t x1 = (box.x + box.w < clip.x + clip.w) ? box.x + box.w : clip.x + clip.w;
+		int16_t y1 = (box.y + box.h < clip.y + clip.h) ? box.y + box.h : clip.y + clip.h;
+		gfx.markDirty(x0, y0, x1 - x0, y1 - y0);
+	}
+}
+
+/*!
+	@brief Draws one op, no culling is done
+	@param gfx graphics object to draw on
+	@param op recorded op
+*/
+void OLEDDisplayList::drawOp(SSD1306_graphics &gfx, const OLEDDrawOp_t &op)
+{
+	const int16_t *p = op.p;
+	switch (op.type)
+	{
+		case OLEDOp_Pixel: gfx.drawPixel(p[0], p[1], op.color); break;
+		case OLEDOp_Line: gfx.drawLine(p[0], p[1], p[2], p[3], op.color); break;
+		case OLEDOp_Rect: gfx.drawRect(p[0], p[1], p[2], p[3], op.color); break;
+		case OLEDOp_FillRect: gfx.fillRect(p[0], p[1], p[2], p[3], op.color); break;
+		case OLEDOp_Circle: gfx.drawCircle(p[0], p[1], p[2], op.color); break;
+		case OLEDOp_FillCircle: gfx.fillCircle(p[0], p[1], p[2], op.color); break;
+		case OLEDOp_RoundRect: gfx.drawRoundRect(p[0], p[1], p[2], p[3], p[4], op.color); break;
+		case OLEDOp_FillRoundRect: gfx.fillRoundRect(p[0], p[1], p[2], p[3], p[4], op.color); break;
+		case OLEDOp_Triangle: gfx.drawTriangle(p[0], p[1], p[2], p[3], p[4], p[5], op.color); break;
+		case OLEDOp_FillTriangle: gfx.fillTriangle(p[0], p[1], p[2], p[3], p[4], p[5], op.color); break;
+		case OLEDOp_Text: drawTextOp(gfx, op); break;
+		case OLEDOp_Bitmap: drawBitmapOp(gfx, op); break;
+	}
+}
+
+/*!
+	@brief Appends an op record , used internally
+	@param type drawing call
+	@param color foreground color
+	@param x bounding box x
+	@param y bounding box y
+	@param w bounding box width
+	@param h bounding box height
+	@return pointer to the new record , nullptr if the arena is full
+*/
+OLEDDrawOp_t* OLEDDisplayList::append(OLEDDrawOp_e type, uint8_t color, int16_t x, int16_t y, int16_t w, int16_t h)
+{
+	if (_count >= _maxOps)
+	{
+		_overflow = true;
+		OLED_ERROR(OLED_DisplayListFull, "displaylist 1", "Op arena full, %u records\r\n", _maxOps);
+		return nullptr;
+	}
+	OLEDDrawOp_t *pOp = &_pOps[_count++];
+	pOp->type = type;
+	pOp->color = color;
+	pOp->bg = color;
+	pOp->font = 0;
+	pOp->size = 1;
+	pOp->box = OLEDRect_t{x, y, w, h};
+	pOp->pData = nullptr;
+	return pOp;
+}
+
+/*!
+	@brief Draws a text op , used internally
+	@param gfx graphics object to draw on
+	@param op recorded op
+	@note Characters outside the clip rectangle are skipped. The font and
+		text size of gfx are restored afterwards.
+*/
+void OLEDDisplayList::drawTextOp(SSD1306_graphics &gfx, const OLEDDrawOp_t &op)
+{
+	uint8_t oldFont = gfx.getFontNum();
+	uint8_t oldSize = gfx.getTextSize();
+	if (oldFont != op.font) gfx.setFontNum((OLEDFontType_e)op.font);
+	if (oldSize != op.size) gfx.setTextSize(op.size);
+
+	const int16_t advance = gfx.getCharAdvance();
+	const int16_t lineHeight = gfx.getLineHeight();
+	const OLEDRect_t clip = gfx.getClipRect();
+	int16_t cx = op.p[0];
+	int16_t cy = op.p[1];
+	for (const char *pChar = (const char *)op.pData; *pChar != '\0'; pChar++)
+	{
+		if (*pChar == '\n')
+		{
+			cx = op.p[0];
+			cy += lineHeight;
+			continue;
+		}
+		if (OLEDRectOverlap(OLEDRect_t{cx, cy, advance, lineHeight}, clip))
+		{
+			if (op.font < OLEDFont_Bignum)
+				gfx.drawChar(cx, cy, (unsigned char)*pChar, op.color, op.bg, op.size);
+			else
+				gfx.drawChar(cx, cy, (uint8_t)*pChar, op.color, op.bg);
+		}
+		cx += advance;
+	}
+
+	if (oldFont != op.font) gfx.setFontNum((OLEDFontType_e)oldFont);
+	if (oldSize != op.size) gfx.setTextSize(oldSize);
+}
+
+/*!
+	@brief Draws a bitmap op , used internally
+	@param gfx graphics object to draw on
+	@param op recorded op
+	@note Only the part of the bitmap inside the clip rectangle is visited.
+*/
+void OLEDDisplayList::drawBitmapOp(SSD1306_graphics &gfx, const OLEDDrawOp_t &op)
+{
+	const OLEDRect_t clip = gfx.getClipRect();
+	const int16_t x = op.p[0];
+	const int16_t y = op.p[1];
+	const int16_t byteWidth = (op.p[2] + 7) / 8;
+	int16_t x0 = (x > clip.x) ? x : clip.x;
+	int16_t y0 = (y > clip.y) ? y : clip.y;
+	int16_t x1 = (x + op.p[2] < clip.x + clip.w) ? x + op.p[2] : clip.x + clip.w;
+	int16_t y1 = (y + op.p[3] < clip.y + clip.h) ? y + op.p[3] : clip.y + clip.h;
+	const uint8_t *pData = (const uint8_t *)op.pData;
+
+	for (int16_t j = y0; j < y1; j++)
+	{
+		const uint8_t *pRow = pData + (j - y) * byteWidth;
+		for (int16_t i = x0; i < x1; i++)
+		{
+			if (pRow[(i - x) >> 3] & (0x80 >> ((i - x) & 7)))
+				gfx.drawPixel(i, j, op.color);
+			else if (op.bg != op.color)
+				gfx.drawPixel(i, j, op.bg);
+		}
+	}
+}
@@ -0,0 +1,101 @@
+/*!
+	@file ssd1306_oled_displaylist.h
+	@brief OLED driven by SSD1306 controller. header file
+		for the display list functions.
+	@details Records drawing calls as fixed size op records in a user supplied
+		arena instead of drawing them. A list can be replayed any number of
+		times into the whole screen, one page band or a damaged rectangle.
+		Each op carries its bounding box and ops outside the replay area are
+		skipped, so static parts of a scene are recorded once and redrawn
+		only where something changed.
+*/
+
+#pragma once
+
+#include "ssd1306_oled_graphics.h"
+
+/*! Enum to define the drawing call held in a display list op */
+enum OLEDDrawOp_e : uint8_t
+{
+	OLEDOp_Pixel = 0,         /**< drawPixel */
+	OLEDOp_Line = 1,          /**< drawLine */
+	OLEDOp_Rect = 2,          /**< drawRect */
+	OLEDOp_FillRect = 3,      /**< fillRect */
+	OLEDOp_Circle = 4,        /**< drawCircle */
+	OLEDOp_FillCircle = 5,    /**< fillCircle */
+	OLEDOp_RoundRect = 6,     /**< drawRoundRect */
+	OLEDOp_FillRoundRect = 7, /**< fillRoundRect */
+	OLEDOp_Triangle = 8,      /**< drawTriangle */
+	OLEDOp_FillTriangle = 9,  /**< fillTriangle */
+	OLEDOp_Text = 10,         /**< string in a recorded font and size */
+	OLEDOp_Bitmap = 11        /**< horizontally addressed bitmap */
+};
+
+/*!
+	@brief Struct to hold one recorded drawing call
+	@details p holds the arguments in the order of the graphics call,
+		x y w h for rectangles and bitmaps, x0 y0 r for circles.
+*/
+struct OLEDDrawOp_t
+{
+	OLEDDrawOp_e type;   /**< Drawing call */
+	uint8_t color;       /**< Foreground color */
+	uint8_t bg;          /**< Background color of text and bitmaps, equal to color is transparent */
+	uint8_t font;        /**< Font number of text */
+	uint8_t size;        /**< Text size of text */
+	int16_t p[6];        /**< Coordinates */
+	OLEDRect_t box;      /**< Bounding box used for culling */
+	const void *pData;   /**< String or bitmap data, not copied */
+};
+
+/*!
+	@brief class to record drawing calls and replay them later
+	@note Strings and bitmaps are referenced, not copied, they must outlive the list.
+*/
+class OLEDDisplayList
+{
+  public:
+	OLEDDisplayList(){};
+
+	bool begin(OLEDDrawOp_t *pOps, uint16_t maxOps);
+	void clear(void);
+	uint16_t size(void) const;
+	uint16_t capacity(void) const;
+	bool overflowed(void) const;
+	OLEDRect_t bounds(void) const;
+
+	bool drawPixel(int16_t x, int16_t y, uint8_t color);
+	bool drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t color);
+	bool drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color);
+	bool fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color);
+	bool drawCircle(int16_t x0, int16_t y0, int16_t r, uint8_t color);
+	bool fillCircle(int16_t x0, int16_t y0, int16_t r, uint8_t color);
+	bool drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint8_t color);
+	bool fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint8_t color);
+	bool drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+	  int16_t x2, int16_t y2, uint8_t color);
+	bool fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+	  int16_t x2, int16_t y2, uint8_t color);
+	bool drawText(SSD1306_graphics &gfx, int16_t x, int16_t y, const char *pText,
+	  uint8_t color, uint8_t bg);
+	bool drawBitmap(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t *pData,
+	  uint8_t color, uint8_t bg);
+
+	uint16_t replay(SSD1306_graphics &gfx) const;
+	uint16_t replay(SSD1306_graphics &gfx, int16_t x, int16_t y, int16_t w, int16_t h) const;
+	uint16_t replayPage(SSD1306_graphics &gfx, uint8_t page) const;
+	void markDirty(SSD1306_graphics &gfx) const;
+
+	static void drawOp(SSD1306_graphics &gfx, const OLEDDrawOp_t &op);
+
+  private:
+
+	OLEDDrawOp_t* append(OLEDDrawOp_e type, uint8_t color, int16_t x, int16_t y, int16_t w, int16_t h);
+	static void drawTextOp(SSD1306_graphics &gfx, const OLEDDrawOp_t &op);
+	static void drawBitmapOp(SSD1306_graphics &gfx, const OLEDDrawOp_t &op);
+
+	OLEDDrawOp_t *_pOps = nullptr; /**< Op arena */
+	uint16_t _maxOps = 0;          /**< Number of op records in arena */
+	uint16_t _count = 0;           /**< Number of ops recorded */
+	bool _overflow = false;        /**< An op was dropped because the arena was full */
+};
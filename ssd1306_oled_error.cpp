@@ -0,0 +1,112 @@
+/*!
+	@file ssd1306_oled_error.cpp
+	@brief OLED driven by SSD1306 controller. Source file
+		for the error reporting.
+*/
+
+#include "ssd1306_oled_error.h"
+#include "hardware/sync.h"
+
+#ifndef OLED_ERROR_SPINLOCK
+#define OLED_ERROR_SPINLOCK PICO_SPINLOCK_ID_STRIPED_FIRST /**< Hardware spinlock guarding the counters, shared striped lock */
+#endif
+
+static uint32_t OLEDErrorCounts[OLED_ERROR_CODES]; // per return code
+static uint32_t OLEDErrorSequence = 0;             // errors since last clear
+static OLEDErrorHook_t OLEDErrorHookFn = nullptr;
+#if OLED_ERROR_HISTORY > 0
+static OLEDErrorRecord_t OLEDErrorHistory[OLED_ERROR_HISTORY]; // ring, oldest overwritten
+#endif
+
+/*!
+	@brief Counts an error, records it in the history and calls the hook
+	@param code OLED_Return_Codes_e
+	@param where string literal naming the function and check
+	@note Normally called through the OLED_ERROR macro. Safe from both cores
+		and from interrupts, the counters and history are updated under a
+		hardware spinlock. The hook runs outside it.
+*/
+void OLEDReportError(OLED_Return_Codes_e code, const char *where)
+{
+	spin_lock_t *pLock = spin_lock_instance(OLED_ERROR_SPINLOCK);
+	uint32_t saved = spin_lock_blocking(pLock);
+	if (code < OLED_ERROR_CODES)
+		OLEDErrorCounts[code]++;
+#if OLED_ERROR_HISTORY > 0
+	OLEDErrorRecord_t &record = OLEDErrorHistory[OLEDErrorSequence % OLED_ERROR_HISTORY];
+	record.code = code;
+	record.where = where;
+	record.sequence = OLEDErrorSequence;
+#endif
+	OLEDErrorSequence++;
+	spin_unlock(pLock, saved);
+	if (OLEDErrorHookFn != nullptr)
+		OLEDErrorHookFn(code, where);
+}
+
+/*!
+	@brief Gets how often an error occurred since the last clear
+	@param code OLED_Return_Codes_e
+	@return count
+*/
+uint32_t OLEDErrorCount(OLED_Return_Codes_e code)
+{
+	return (code < OLED_ERROR_CODES) ? OLEDErrorCounts[code] : 0;
+}
+
+/*!
+	@brief Gets the number of errors of any kind since the last clear
+	@return count
+*/
+uint32_t OLEDErrorTotal(void)
+{
+	return OLEDErrorSequence;
+}
+
+/*!
+	@brief Copies the most recent errors, newest first
+	@param pRecords destination array
+	@param maxRecords size of destination array
+	@return number of records copied, at most OLED_ERROR_HISTORY
+*/
+uint8_t OLEDRecentErrors(OLEDErrorRecord_t *pRecords, uint8_t maxRecords)
+{
+	uint8_t count = 0;
+#if OLED_ERROR_HISTORY > 0
+	if (pRecords == nullptr) return 0;
+	spin_lock_t *pLock = spin_lock_instance(OLED_ERROR_SPINLOCK);
+	uint32_t saved = spin_lock_blocking(pLock);
+	uint32_t held = (OLEDErrorSequence < OLED_ERROR_HISTORY) ? OLEDErrorSequence : OLED_ERROR_HISTORY;
+	while (count < held && count < maxRecords)
+	{
+		pRecords[count] = OLEDErrorHistory[(OLEDErrorSequence - 1 - count) % OLED_ERROR_HISTORY];
+		count++;
+	}
+	spin_unlock(pLock, saved);
+#else
+	(void)pRecords; (void)maxRecords;
+#endif
+	return count;
+}
+
+/*!
+	@brief Resets the counters and the history
+*/
+void OLEDClearErrors(void)
+{
+	spin_lock_t *pLock = spin_lock_instance(OLED_ERROR_SPINLOCK);
+	uint32_t saved = spin_lock_blocking(pLock);
+	for (uint8_t i = 0; i < OLED_ERROR_CODES; i++)
+		OLEDErrorCounts[i] = 0;
+	OLEDErrorSequence = 0;
+	spin_unlock(pLock, saved);
+}
+
+/*!
+	@brief Sets a function called for every error
+	@param hook function pointer, nullptr removes the hook
+*/
+void OLEDSetErrorHook(OLEDErrorHook_t hook)
+{
+	OLEDErrorHookFn = hook;
+}
@@ -0,0 +1,98 @@
+/*!
+	@file ssd1306_oled_error.h
+	@brief OLED driven by SSD1306 controller. header file
+		for the return codes and error reporting.
+	@details Errors are counted per return code, kept in a small history of
+		recent errors and passed to an optional user hook. Printing a message
+		is chosen at compile time with OLED_LOG_LEVEL, at the default level
+		the format strings are compiled out so an error costs a counter update.
+*/
+
+#pragma once
+
+#include <cstdio>
+#include <cstdint>
+
+#define OLED_LOG_NONE  0 /**< No messages, errors are only counted */
+#define OLED_LOG_ERROR 1 /**< printf a message where an error is detected */
+#define OLED_LOG_TRACE 2 /**< also printf where an error is passed on to the caller */
+
+#ifndef OLED_LOG_LEVEL
+#define OLED_LOG_LEVEL OLED_LOG_NONE /**< Compile time log level */
+#endif
+
+#ifndef OLED_ERROR_HISTORY
+#define OLED_ERROR_HISTORY 8 /**< Number of recent errors kept, 0 disables the history */
+#endif
+
+#define OLED_ERROR_CODES 32 /**< Number of return codes with a counter */
+
+/*! Enum to define return codes from some text and bitmap functions  */
+enum OLED_Return_Codes_e : uint8_t
+{
+	OLED_Success = 0,                /**< Success!*/
+	OLED_WrongFont = 2,              /**< Wrong Font selected for this method, There are two families of font included with different overloaded functions*/
+	OLED_CharScreenBounds = 3,       /**< Text Character is out of Screen bounds, Check x and y*/
+	OLED_CharFontASCIIRange = 4,     /**< Text Character is outside of chosen Fonts ASCII range, Check the selected Fonts ASCII range.*/
+	OLED_CharArrayNullptr = 5,       /**< Text Character Array is an invalid pointer object*/
+	OLED_BitmapNullptr = 7,          /**< The Bitmap data array is an invalid pointer object*/
+	OLED_BitmapScreenBounds = 8,     /**< The bitmap starting point is outside screen bounds check x and y*/
+	OLED_BitmapLargerThanScreen = 9, /**< The Bitmap is larger than screen, check  w and h*/
+	OLED_BitmapVerticalSize = 10,    /**< A vertical Bitmap's height must be divisible by 8. */
+	OLED_BitmapHorizontalSize = 11,  /**< A horizontal Bitmap's width  must be divisible by 8  */
+	OLED_BitmapSize = 12,            /**< Size of the Bitmap is incorrect: BitmapSize(vertical)!=(w*(h/8),BitmapSize(horizontal)!=(w/8)*h*/
+	OLED_CustomCharLen = 13,         /**< CustomChar array must always be 5 bytes long*/
+	OLED_BufferSize = 14,            /**< A user supplied buffer has the wrong size for the screen */
+	OLED_BufferNullptr = 15,         /**< A user supplied buffer is an invalid pointer object */
+	OLED_DisplayListFull = 16,       /**< The display list arena has no free op record */
+	OLED_SceneFull = 17,             /**< The scene node arena has no free node */
+	OLED_SceneNodeInvalid = 18,      /**< The scene node id does not exist or has the wrong type */
+	OLED_LayerInvalid = 19,          /**< The layer number does not exist or all layers are in use */
+	OLED_RegionStack = 20,           /**< Save-under stack is empty or full, or its arena is too small */
+	OLED_TransferAbort = 21,         /**< The I2C controller aborted a background transfer, no acknowledge */
+	OLED_MuxSelect = 22,             /**< The multiplexer channel is out of range or the multiplexer did not acknowledge */
+	OLED_ModeConflict = 23,          /**< The function can not be used with a display mode that is on, e.g. double buffering */
+	OLED_TransferState = 24          /**< A transfer mode can not start in the current state, e.g. no hidden display RAM or the controller is taken */
+};
+
+/*! @brief Struct to hold one entry of the recent error history */
+struct OLEDErrorRecord_t
+{
+	OLED_Return_Codes_e code; /**< Return code of the error */
+	const char *where;        /**< Short name of the function and check that failed */
+	uint32_t sequence;        /**< Running number of the error since the last clear */
+};
+
+/*! Function called for every error, runs in the context of the failing call */
+typedef void (*OLEDErrorHook_t)(OLED_Return_Codes_e code, const char *where);
+
+void OLEDReportError(OLED_Return_Codes_e code, const char *where);
+uint32_t OLEDErrorCount(OLED_Return_Codes_e code);
+uint32_t OLEDErrorTotal(void);
+uint8_t OLEDRecentErrors(OLEDErrorRecord_t *pRecords, uint8_t maxRecords);
+void OLEDClearErrors(void);
+void OLEDSetErrorHook(OLEDErrorHook_t hook);
+
+/*!
+	@brief Reports an error where it is detected
+	@param code OLED_Return_Codes_e
+	@param where string literal naming the function and check e.g. "drawChar 2"
+	@param ... printf format and arguments , only compiled at OLED_LOG_ERROR and above
+*/
+#if OLED_LOG_LEVEL >= OLED_LOG_ERROR
+#define OLED_ERROR(code, where, ...) \
+	do { OLEDReportError(code, where); printf("Error " where ": " __VA_ARGS__); } while (0)
+#else
+#define OLED_ERROR(code, where, ...) OLEDReportError(code, where)
+#endif
+
+/*!
+	@brief Notes an error passed on from a called function, it is not counted again
+	@param where string literal naming the function and check
+	@param ... printf format and arguments , only compiled at OLED_LOG_TRACE
+*/
+#if OLED_LOG_LEVEL >= OLED_LOG_TRACE
+#define OLED_TRACE(where, ...) printf("Error " where ": " __VA_ARGS__)
+#else
+#define OLED_TRACE(where, ...) do { } while (0)
+#endif
@@ -0,0 +1,292 @@
+/*!
+	@file ssd1306_oled_flush.cpp
+	@brief OLED driven by SSD1306 controller. Source file
+		for the core1 flush service.
+*/
+
+#include "ssd1306_oled_flush.h"
+
+OLEDFlushService * volatile OLEDFlushService::_pCore1Service = nullptr;
+
+/*!
+	@brief Sets the frame buffers and points the display at the first
+	@param pBuffers pointer to OLED_FLUSH_SLOTS buffers of width * (height/8) bytes back to back
+	@param sizeOfBuffers size of all buffers
+	@return true for success
+	@note The current display buffer contents are copied into all three buffers.
+*/
+bool OLEDFlushService::begin(uint8_t *pBuffers, uint16_t sizeOfBuffers)
+{
+	const uint16_t frameSize = _width * (_height / 8);
+	if (pBuffers == nullptr || sizeOfBuffers != OLED_FLUSH_SLOTS * frameSize)
+	{
+		OLED_ERROR(OLED_BufferSize, "flush begin 1", "buffers must be %u bytes\r\n", OLED_FLUSH_SLOTS * frameSize);
+		return false;
+	}
+#if PICO_ON_DEVICE
+	if (_pLock == nullptr)
+		_pLock = spin_lock_instance(spin_lock_claim_unused(true));
+#endif
+
+	_pBuffers = pBuffers;
+	_draw = 0;
+	_ready = 1;
+	_send = 2;
+	_fresh = false;
+	for (uint8_t slot = 0; slot < OLED_FLUSH_SLOTS; slot++)
+	{
+		memset(_dirtyX0[slot], 0xFF, SSD1306_GDDRAM_PAGES);
+		memset(_dirtyX1[slot], 0x00, SSD1306_GDDRAM_PAGES);
+		_publishUs[slot] = 0;
+	}
+	resetStats();
+	return _oled.OLEDSetBufferPtr(_width, _height, slotBuffer(_draw), frameSize);
+}
+
+/*!
+	@brief Starts sending on core1, or on a thread on host builds
+	@return false if begin was not called or the service runs already
+	@note On the device core1 is launched, it must be free.
+*/
+bool OLEDFlushService::start(void)
+{
+	if (_pBuffers == nullptr || _running || _pCore1Service != nullptr) return false;
+	_pCore1Service = this;
+	_running = true;
+#if PICO_ON_DEVICE
+	multicore_launch_core1(core1Entry);
+#else
+	_thread = std::thread(core1Entry);
+#endif
+	return true;
+}
+
+/*!
+	@brief Stops the sending core after the transfer in progress
+*/
+void OLEDFlushService::stop(void)
+{
+	if (!_running) return;
+	_running = false;
+#if PICO_ON_DEVICE
+	__sev();
+	while (_pCore1Service != nullptr) tight_loop_contents();
+	multicore_reset_core1();
+#else
+	_thread.join();
+#endif
+}
+
+/*!
+	@brief Checks if the sending core runs
+	@return true while started
+*/
+bool OLEDFlushService::isRunning(void) const {return _running;}
+
+/*!
+	@brief Hands the finished frame to the sending core, never waits for the display
+	@param carryForward true copy the frame into the next drawing buffer so
+		drawing continues from it, false when every frame is drawn in full
+	@details If the previous frame was not picked up yet it is dropped and
+		its dirty areas are added to this one.
+*/
+void OLEDFlushService::publish(bool carryForward)
+{
+	if (_pBuffers == nullptr) return;
+	uint8_t x0, x1;
+	bool marked = false;
+	for (uint8_t page = 0; page < SSD1306_GDDRAM_PAGES; page++)
+	{
+		if (_oled.OLEDGetDirty(page, x0, x1))
+		{
+			_dirtyX0[_draw][page] = x0;
+			_dirtyX1[_draw][page] = x1;
+			marked = true;
+		}
+	}
+	if (!marked)
+	{
+		for (uint8_t page = 0; page < (_height / 8); page++)
+		{
+			_dirtyX0[_draw][page] = 0;
+			_dirtyX1[_draw][page] = _width - 1;
+		}
+	}
+	_oled.OLEDClearDirty();
+	const uint64_t now = time_us_64();
+
+	uint32_t saved = lock();
+	if (_fresh)
+	{
+		for (uint8_t page = 0; page < SSD1306_GDDRAM_PAGES; page++)
+		{
+			if (_dirtyX0[_ready][page] < _dirtyX0[_draw][page]) _dirtyX0[_draw][page] = _dirtyX0[_ready][page];
+			if (_dirtyX1[_ready][page] > _dirtyX1[_draw][page]) _dirtyX1[_draw][page] = _dirtyX1[_ready][page];
+		}
+		_stats.dropped++;
+	}
+	uint8_t done = _draw;
+	_draw = _ready;
+	_ready = done;
+	_publishUs[done] = now;
+	_fresh = true;
+	_stats.published++;
+	unlock(saved);
+#if PICO_ON_DEVICE
+	__sev();
+#endif
+
+	memset(_dirtyX0[_draw], 0xFF, SSD1306_GDDRAM_PAGES);
+	memset(_dirtyX1[_draw], 0x00, SSD1306_GDDRAM_PAGES);
+	const uint16_t frameSize = _width * (_height / 8);
+	if (carryForward)
+		memcpy(slotBuffer(_draw), slotBuffer(done), frameSize);
+	_oled.OLEDSetBufferPtr(_width, _height, slotBuffer(_draw), frameSize);
+}
+
+/*!
+	@brief Sends the newest published frame if any, runs on the sending core
+	@return true if a frame was sent
+	@note Called by the service loop, call it directly to run the transfer
+		from an own loop instead of start().
+*/
+bool OLEDFlushService::serviceOnce(void)
+{
+	uint8_t dirtyX0[SSD1306_GDDRAM_PAGES];
+	uint8_t dirtyX1[SSD1306_GDDRAM_PAGES];
+
+	uint32_t saved = lock();
+	if (!_fresh)
+	{
+		unlock(saved);
+		return false;
+	}
+	uint8_t taken = _ready;
+	_ready = _send;
+	_send = taken;
+	_fresh = false;
+	unlock(saved);
+
+	memcpy(dirtyX0, _dirtyX0[_send], sizeof(dirtyX0));
+	memcpy(dirtyX1, _dirtyX1[_send], sizeof(dirtyX1));
+	memset(_dirtyX0[_send], 0xFF, SSD1306_GDDRAM_PAGES);
+	memset(_dirtyX1[_send], 0x00, SSD1306_GDDRAM_PAGES);
+
+	const uint8_t *pFrame = slotBuffer(_send);
+	uint8_t pages = _height / 8;
+	uint8_t page = 0;
+	while (page < pages)
+	{
+		if (dirtyX0[page] > dirtyX1[page]) {page++; continue;}
+		uint8_t x0 = dirtyX0[page];
+		uint8_t x1 = dirtyX1[page];
+		uint8_t last = page;
+		while (last + 1 < pages && dirtyX0[last + 1] == x0 && dirtyX1[last + 1] == x1) last++;
+
+		_oled.OLEDSetWindow(x0, x1, page, last);
+		for (; page <= last; page++)
+			_oled.OLEDWriteData(&pFrame[(_width * page) + x0], x1 - x0 + 1);
+	}
+
+	uint32_t latency = (uint32_t)(time_us_64() - _publishUs[_send]);
+	saved = lock();
+	_stats.sent++;
+	_stats.lastLatencyUs = latency;
+	if (latency > _stats.maxLatencyUs) _stats.maxLatencyUs = latency;
+	_stats.totalLatencyUs += latency;
+	unlock(saved);
+	return true;
+}
+
+/*!
+	@brief Gets the counters
+	@return copy of the counters
+*/
+OLEDFlushStats_t OLEDFlushService::stats(void) const
+{
+#if PICO_ON_DEVICE
+	if (_pLock == nullptr) return _stats;
+#endif
+	uint32_t saved = lock();
+	OLEDFlushStats_t copy = _stats;
+	unlock(saved);
+	return copy;
+}
+
+/*!
+	@brief Sets all counters to 0
+*/
+void OLEDFlushService::resetStats(void)
+{
+#if PICO_ON_DEVICE
+	if (_pLock == nullptr) return;
+#endif
+	uint32_t saved = lock();
+	_stats = OLEDFlushStats_t{};
+	unlock(saved);
+}
+
+/*!
+	@brief Service loop of the sending core , used internally
+*/
+void OLEDFlushService::run(void)
+{
+	while (_running)
+	{
+		if (!serviceOnce())
+		{
+#if PICO_ON_DEVICE
+			__wfe(); // woken by publish
+#else
+			std::this_thread::yield();
+#endif
+		}
+	}
+}
+
+/*!
+	@brief Entry point of the sending core , used internally
+*/
+void OLEDFlushService::core1Entry(void)
+{
+	_pCore1Service->run();
+	_pCore1Service = nullptr;
+}
+
+/*!
+	@brief Gets the buffer of a slot , used internally
+	@param slot slot number
+	@return pointer to frame buffer
+*/
+uint8_t *OLEDFlushService::slotBuffer(uint8_t slot) const
+{
+	return _pBuffers + (slot * _width * (_height / 8));
+}
+
+/*!
+	@brief Takes the slot exchange lock , used internally
+	@return saved interrupt state for unlock
+*/
+uint32_t OLEDFlushService::lock(void) const
+{
+#if PICO_ON_DEVICE
+	return spin_lock_blocking(_pLock);
+#else
+	_lock.lock();
+	return 0;
+#endif
+}
+
+/*!
+	@brief Releases the slot exchange lock , used internally
+	@param saved value returned by lock
+*/
+void OLEDFlushService::unlock(uint32_t saved) const
+{
+#if PICO_ON_DEVICE
+	spin_unlock(_pLock, saved);
+#else
+	(void)saved;
+	_lock.unlock();
+#endif
+}
@@ -0,0 +1,102 @@
+/*!
+	@file ssd1306_oled_flush.h
+	@brief OLED driven by SSD1306 controller. header file
+		for the core1 flush service.
+	@details Moves the I2C transfer off the drawing core. Three frame buffers
+		rotate between drawing, ready and sending. Core0 publishes a finished
+		frame by exchanging buffer numbers under a hardware spinlock, which
+		takes a few instructions and never waits for the display. Host builds
+		use a thread for core1 and a mutex for the spinlock. Core1 sends
+		the newest published frame, a frame replaced before core1 picked it
+		up is dropped and its dirty areas go with the newer one.
+*/
+
+#pragma once
+
+#include "ssd1306_oled.h"
+#include "hardware/sync.h"
+#if PICO_ON_DEVICE
+#include "pico/multicore.h"
+#else
+#include <thread>
+#include <mutex>
+#include <atomic>
+#endif
+
+#define OLED_FLUSH_SLOTS 3 /**< Frame buffers used by the flush service */
+
+/*! @brief Struct to hold flush service counters */
+struct OLEDFlushStats_t
+{
+	uint32_t published;     /**< Frames published by the drawing core */
+	uint32_t sent;          /**< Frames sent to the display */
+	uint32_t dropped;       /**< Frames replaced by a newer one before sending */
+	uint32_t lastLatencyUs; /**< Publish to end of transfer, last frame sent */
+	uint32_t maxLatencyUs;  /**< Publish to end of transfer, worst frame sent */
+	uint64_t totalLatencyUs; /**< Sum of latencies, divide by sent for the mean */
+};
+
+/*!
+	@brief class to send frames to the display from the other core
+	@details Call publish() on the drawing core when a frame is finished, the
+		display object then draws into the next free buffer. Dirty areas
+		marked with markDirty are sent as windows, with none marked the whole
+		frame is sent.
+	@note Only the service may use I2C of the display while it runs. Do not
+		combine it with OLEDSetSecondBuffer or page flipping.
+*/
+class OLEDFlushService
+{
+  public:
+	OLEDFlushService(SSD1306 &oled, uint8_t width, uint8_t height) :
+		_oled(oled), _width(width), _height(height) {};
+
+	bool begin(uint8_t *pBuffers, uint16_t sizeOfBuffers);
+	bool start(void);
+	void stop(void);
+	bool isRunning(void) const;
+
+	void publish(bool carryForward = true);
+	bool serviceOnce(void);
+
+	OLEDFlushStats_t stats(void) const;
+	void resetStats(void);
+
+  private:
+
+	void run(void);
+	static void core1Entry(void);
+	uint8_t *slotBuffer(uint8_t slot) const;
+	uint32_t lock(void) const;
+	void unlock(uint32_t saved) const;
+
+	SSD1306 &_oled;                  /**< Display drawn on and sent to */
+	uint8_t _width;                  /**< Width of frame buffers in pixels */
+	uint8_t _height;                 /**< Height of frame buffers in pixels */
+	uint8_t *_pBuffers = nullptr;    /**< OLED_FLUSH_SLOTS frame buffers back to back */
+#if PICO_ON_DEVICE
+	spin_lock_t *_pLock = nullptr;   /**< Hardware spinlock guarding the slot exchange */
+#else
+	mutable std::mutex _lock;        /**< Guards the slot exchange on host builds */
+#endif
+
+	uint8_t _draw = 0;               /**< Slot the drawing core draws into */
+	uint8_t _ready = 1;              /**< Slot holding the newest published frame */
+	uint8_t _send = 2;               /**< Slot owned by the sending core */
+	bool _fresh = false;             /**< Ready slot holds a frame not yet taken , under the lock */
+#if PICO_ON_DEVICE
+	volatile bool _running = false;  /**< Service loop active */
+#else
+	std::atomic<bool> _running{false}; /**< Service loop active */
+#endif
+
+	uint8_t _dirtyX0[OLED_FLUSH_SLOTS][SSD1306_GDDRAM_PAGES]; /**< First dirty column per slot and page */
+	uint8_t _dirtyX1[OLED_FLUSH_SLOTS][SSD1306_GDDRAM_PAGES]; /**< Last dirty column per slot and page */
+	uint64_t _publishUs[OLED_FLUSH_SLOTS]; /**< Publish time per slot */
+	OLEDFlushStats_t _stats{};       /**< Counters, written under the lock */
+
+#if !PICO_ON_DEVICE
+	std::thread _thread;             /**< Stands in for core1 on host builds */
+#endif
+	static OLEDFlushService * volatile _pCore1Service; /**< Service run by core1Entry , cleared by core1 when it stops */
+};
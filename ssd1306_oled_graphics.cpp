@@ -8,6 +8,24 @@
 
 #include "ssd1306_oled_graphics.h"
 
+// Each nibble with every bit doubled, used to scale glyph columns by 2 and 4
+static const uint8_t OLEDExpandNibble2[16] = {
+	0x00, 0x03, 0x0C, 0x0F, 0x30, 0x33, 0x3C, 0x3F,
+	0xC0, 0xC3, 0xCC, 0xCF, 0xF0, 0xF3, 0xFC, 0xFF
+};
+
+// Each nibble with every bit tripled, used to scale glyph columns by 3
+static const uint16_t OLEDExpandNibble3[16] = {
+	0x000, 0x007, 0x038, 0x03F, 0x1C0, 0x1C7, 0x1F8, 0x1FF,
+	0xE00, 0xE07, 0xE38, 0xE3F, 0xFC0, 0xFC7, 0xFF8, 0xFFF
+};
+
+// Each nibble bit reversed, fonts 7-12 store columns MSB first
+static const uint8_t OLEDReverseNibble[16] = {
+	0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE,
+	0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF
+};
+
 /*!
 	@brief init the OLED  Graphics class object
 	@param w width defined  in sub-class
@@ -24,6 +42,7 @@ SSD1306_graphics::SSD1306_graphics(int16_t w, int16_t h):
 	_textColor = 0x00;
 	_textBgColor = 0xFF;
 	_textwrap  = true;
+	clearClipRect();
 }
 
 /*!
@@ -251,6 +270,12 @@ void SSD1306_graphics::drawFastHLine(int16_t x, int16_t y, int16_t w, uint8_t co
 */
 void SSD1306_graphics::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color) 
 {
+	// trim to the clip rectangle, nothing outside it would be drawn
+	if (x < _clipX0) { w -= _clipX0 - x; x = _clipX0; }
+	if (y < _clipY0) { h -= _clipY0 - y; y = _clipY0; }
+	if (x + w > _clipX1) w = _clipX1 - x;
+	if (y + h > _clipY1) h = _clipY1 - y;
+	if (w <= 0 || h <= 0) return;
 	for (int16_t i=x; i<x+w; i++) {
 	drawFastVLine(i, y, h, color);
 	}
@@ -412,7 +437,7 @@ size_t SSD1306_graphics::write(uint8_t character)
 		switch (character)
 		{
 		case '\n':
-			_cursor_y += _textSize*_CurrentFontheight;
+			_cursor_y += getLineHeight();
 			_cursor_x  = 0;
 		break;
 		case '\r': /* skip */
@@ -421,13 +446,13 @@ size_t SSD1306_graphics::write(uint8_t character)
 			DrawCharReturnCode = drawChar(_cursor_x, _cursor_y, character, _textColor, _textBgColor, _textSize) ;
 			if(DrawCharReturnCode  != OLED_Success)
 			{
-				printf( "Error write_print method 1: Method drawChar failed:  %i\n",DrawCharReturnCode);
+				OLED_TRACE("write_print method 1", "Method drawChar failed:  %i\n",DrawCharReturnCode);
 				return DrawCharReturnCode;
 			}
-			_cursor_x += _textSize*(_CurrentFontWidth+1);
-			if (_textwrap && (_cursor_x > (_width - _textSize*(_CurrentFontWidth+1)))) 
+			_cursor_x += getCharAdvance();
+			if (_textwrap && (_cursor_x > wrapLimit())) 
 			{
-				_cursor_y += _textSize*_CurrentFontheight;
+				_cursor_y += getLineHeight();
 				_cursor_x = 0;
 			}
 		break;
@@ -438,7 +463,7 @@ size_t SSD1306_graphics::write(uint8_t character)
 		switch (character)
 		{
 			case '\n': 
-				_cursor_y += _CurrentFontheight;
+				_cursor_y += getLineHeight();
 				_cursor_x  = 0;
 			break;
 			case '\r': /* skip */  break;
@@ -446,13 +471,13 @@ size_t SSD1306_graphics::write(uint8_t character)
 				DrawCharReturnCode = drawChar(_cursor_x, _cursor_y, character, _textColor, _textBgColor) ;
 				if(DrawCharReturnCode  != OLED_Success)
 				{
-					printf( "Error write_print method 2 : Method drawChar failed: %i\n",DrawCharReturnCode);
+					OLED_TRACE("write_print method 2", "Method drawChar failed: %i\n",DrawCharReturnCode);
 					return DrawCharReturnCode;
 				}
-				_cursor_x += (_CurrentFontWidth);
-				if (_textwrap && (_cursor_x  > (_width - (_CurrentFontWidth+1)))) 
+				_cursor_x += getCharAdvance();
+				if (_textwrap && (_cursor_x  > wrapLimit())) 
 				{
-					_cursor_y += _CurrentFontheight;
+					_cursor_y += getLineHeight();
 					_cursor_x = 0;
 				}
 			break;
@@ -461,6 +486,77 @@ size_t SSD1306_graphics::write(uint8_t character)
   return 1;
 }
 
+/*!
+	@brief called by the print class to write a run of characters
+	@param buffer characters to write
+	@param size number of characters
+	@return number of characters consumed
+	@details Fast path for print() of strings and numbers. The font family and
+		metrics are resolved once for the run, glyphs are looked up directly
+		and drawn without the per character checks of drawChar.
+		Cursor movement, newline and wrap follow write(uint8_t). Characters
+		outside the font or the screen are skipped, each kind reported once
+		with the code drawChar would return for it.
+*/
+size_t SSD1306_graphics::write(const uint8_t *buffer, size_t size)
+{
+	if (buffer == nullptr) return 0;
+
+	const uint8_t glyphSize = (_FontNumber < OLEDFont_Bignum) ? _textSize : 1;
+	const int16_t advance = getCharAdvance();
+	const int16_t lineHeight = getLineHeight();
+	const int16_t limit = wrapLimit();
+	const int16_t minX = (_FontNumber < OLEDFont_Bignum) ? (1 - advance) : 0;
+	const int16_t minY = (_FontNumber < OLEDFont_Bignum) ? (1 - lineHeight) : 0;
+	size_t outOfFont = 0;
+	size_t offScreen = 0;
+
+	for (size_t n = 0; n < size; n++)
+	{
+		uint8_t character = buffer[n];
+		switch (character)
+		{
+			case '\n':
+				_cursor_y += lineHeight;
+				_cursor_x  = 0;
+			break;
+			case '\r': /* skip */  break;
+			default:
+			{
+				const uint8_t* pGlyph = getGlyph(character);
+				if (pGlyph == nullptr)
+				{
+					outOfFont++;
+					break;
+				}
+				if (_cursor_x >= _width || _cursor_y >= _height ||
+				_cursor_x < minX || _cursor_y < minY)
+				{
+					offScreen++;
+					break;
+				}
+				renderGlyph(_cursor_x, _cursor_y, pGlyph, _textColor, _textBgColor, glyphSize);
+				_cursor_x += advance;
+				if (_textwrap && (_cursor_x > limit))
+				{
+					_cursor_y += lineHeight;
+					_cursor_x = 0;
+				}
+			}
+			break;
+		}
+	}
+	if (outOfFont)
+	{
+		OLED_ERROR(OLED_CharFontASCIIRange, "write_print method 3", "%u characters out of font range\n", (unsigned int)outOfFont);
+	}
+	if (offScreen)
+	{
+		OLED_ERROR(OLED_CharScreenBounds, "write_print method 4", "%u characters out of screen bounds\n", (unsigned int)offScreen);
+	}
+	return size;
+}
+
 /*!
 	@brief  writes a character on the OLED
 	@param  x X coordinate
@@ -477,7 +573,7 @@ OLED_Return_Codes_e SSD1306_graphics::drawChar(int16_t x, int16_t y, unsigned ch
 	// 1. Check for wrong font
 	if (_FontNumber >= OLEDFont_Bignum)
 	{
-		printf("Error drawChar 1: Wrong font selected, must be font 1-6: %u \r\n",OLED_WrongFont);
+		OLED_ERROR(OLED_WrongFont, "drawChar 1", "Wrong font selected, must be font 1-6: %u \r\n",OLED_WrongFont);
 		return OLED_WrongFont;
 	}
 	// 2. Check for screen out of  bounds
@@ -486,59 +582,170 @@ OLED_Return_Codes_e SSD1306_graphics::drawChar(int16_t x, int16_t y, unsigned ch
 	((x + (_CurrentFontWidth+1) * size - 1) < 0) || // Clip left
 	((y + _CurrentFontheight  * size - 1) < 0))   // Clip top
 	{
-		printf("Error drawChar 2: Co-ordinates out of bounds : %u \r\n",OLED_CharScreenBounds );
+		OLED_ERROR(OLED_CharScreenBounds, "drawChar 2", "Co-ordinates out of bounds : %u \r\n",OLED_CharScreenBounds );
 		return OLED_CharScreenBounds;
 	}
 	// 3. Check for character out of font range bounds
 	if ( character < _CurrentFontoffset || character >= (_CurrentFontLength+ _CurrentFontoffset))
 	{
-		printf("Error drawChar 3: Character out of Font bounds: %u:  %u  %u<->%u \r\n", OLED_CharFontASCIIRange, character,_CurrentFontoffset, (_CurrentFontLength + _CurrentFontoffset));
+		OLED_ERROR(OLED_CharFontASCIIRange, "drawChar 3", "Character out of Font bounds: %u:  %u  %u<->%u \r\n", OLED_CharFontASCIIRange, character,_CurrentFontoffset, (_CurrentFontLength + _CurrentFontoffset));
 		return OLED_CharFontASCIIRange;
 	}
 
-	for (int8_t i=0; i<(_CurrentFontWidth+1); i++ ) {
-	uint8_t line;
-	if (i == _CurrentFontWidth)
-	{ 
-		line = 0x0;
+	renderGlyph(x, y, getGlyph(character), color, bg, size);
+	return OLED_Success;
+}
+
+/*!
+	@brief Draws a glyph already validated against the font and screen, used internally
+	@param x X coordinate
+	@param y Y coordinate
+	@param pGlyph glyph data from getGlyph
+	@param color color
+	@param bg background color
+	@param size 1-x , fonts 1-6 only
+*/
+void SSD1306_graphics::renderGlyph(int16_t x, int16_t y, const uint8_t* pGlyph, uint8_t color, uint8_t bg, uint8_t size)
+{
+	if (_FontNumber < OLEDFont_Bignum)
+	{
+		for (uint8_t i = 0; i < (_CurrentFontWidth+1); i++)
+		{
+			uint8_t line = (i == _CurrentFontWidth) ? 0x00 : pGlyph[i];
+			// Sizes 1-4 expand the column into one bit field and write it whole
+			if (size <= 4)
+			{
+				uint32_t bits = expandColumn(line, size);
+				for (uint8_t k = 0; k < size; k++)
+					drawColumnBits(x+(i*size)+k, y, bits, _CurrentFontheight*size, color, bg);
+				continue;
+			}
+			for (int8_t j = 0; j<_CurrentFontheight ; j++)
+			{
+				if (line & 0x1)
+					fillRect(x+(i*size), y+(j*size), size, size, color);
+				else if (bg != color)
+					fillRect(x+i*size, y+j*size, size, size, bg);
+				line >>= 1;
+			}
+		}
 	}
-	else 
+	else // fonts 7-12 , columns of (height/8) bytes, MSB is the top pixel
 	{
-		switch (_FontNumber) 
+		const uint8_t bytesPerColumn = (_CurrentFontheight + 7) / 8;
+		const uint32_t mask = (_CurrentFontheight >= 32) ? 0xFFFFFFFF : ((1UL << _CurrentFontheight) - 1);
+		for (uint8_t i = 0; i < _CurrentFontWidth; i++)
 		{
-			case OLEDFont_Default : line = pFontDefaultptr[((character - _CurrentFontoffset) * _CurrentFontWidth) + i]; break;
-			case OLEDFont_Thick : line = pFontThickptr[((character - _CurrentFontoffset) * _CurrentFontWidth) + i]; break;
-			case OLEDFont_SevenSeg: line = pFontSevenSegptr[((character - _CurrentFontoffset) * _CurrentFontWidth) + i]; break;
-			case OLEDFont_Wide : line = pFontWideptr[((character - _CurrentFontoffset) * _CurrentFontWidth) + i]; break;
-			case OLEDFont_Tiny : line = pFontTinyptr[((character - _CurrentFontoffset) * _CurrentFontWidth) + i]; break;
-			case OLEDFont_Homespun : line = pFontHomeSpunptr[((character - _CurrentFontoffset) * _CurrentFontWidth) + i]; break;
-		default:
-			printf("Error drawChar 1: Wrong font selected, must be font 1-6 : %u\r\n", OLED_WrongFont);
-			return OLED_WrongFont;
-		break;
-		} //switch font linenumber
+			uint32_t bits = 0;
+			for (uint8_t b = 0; b < bytesPerColumn; b++, pGlyph++)
+			{
+				uint8_t reversed = (OLEDReverseNibble[*pGlyph & 0x0F] << 4) | OLEDReverseNibble[*pGlyph >> 4];
+				bits |= (uint32_t)reversed << (8 * b);
+			}
+			// These fonts always paint the background, even when it equals color
+			if (bg == color) bits = mask;
+			drawColumnBits(x+i, y, bits & mask, _CurrentFontheight, color, bg);
+		}
 	}
+}
 
-	for (int8_t j = 0; j<_CurrentFontheight ; j++) 
+/*!
+	@brief Draws a vertical run of pixels from a bit field, bit 0 is the top pixel
+	@param x X coordinate of the column
+	@param y Y coordinate of the top pixel
+	@param bits pixel data, a set bit is drawn in color , a clear bit in bg
+	@param height number of pixels in the run 1-32
+	@param color foreground color
+	@param bg background color, if equal to color clear bits are left untouched
+	@note Default implementation goes pixel by pixel, a sub-class with access to
+		the buffer can override it to write whole bytes.
+*/
+void SSD1306_graphics::drawColumnBits(int16_t x, int16_t y, uint32_t bits, uint8_t height, uint8_t color, uint8_t bg)
+{
+	for (uint8_t j = 0; j < height; j++, bits >>= 1)
 	{
-		if (line & 0x1) 
-		{
-		if (size == 1) // default size
-			drawPixel(x+i, y+j, color);
-		else  // big size
-			fillRect(x+(i*size), y+(j*size), size, size, color);
-		} else if (bg != color) 
+		if (bits & 0x1)
+			drawPixel(x, y+j, color);
+		else if (bg != color)
+			drawPixel(x, y+j, bg);
+	}
+}
+
+/*!
+	@brief Scales an 8 pixel glyph column vertically with lookup tables
+	@param line glyph column, bit 0 is the top pixel
+	@param size scale factor 1-4
+	@return column of 8*size pixels
+*/
+uint32_t SSD1306_graphics::expandColumn(uint8_t line, uint8_t size)
+{
+	switch (size)
+	{
+		case 2:
+			return OLEDExpandNibble2[line & 0x0F] | (OLEDExpandNibble2[line >> 4] << 8);
+		case 3:
+			return OLEDExpandNibble3[line & 0x0F] | ((uint32_t)OLEDExpandNibble3[line >> 4] << 12);
+		case 4:
 		{
-		if (size == 1) // default size
-			drawPixel(x+i, y+j, bg);
-		else {  // big size
-			fillRect(x+i*size, y+j*size, size, size, bg);
-		}
+			uint16_t twice = OLEDExpandNibble2[line & 0x0F] | (OLEDExpandNibble2[line >> 4] << 8);
+			return expandColumn(twice & 0xFF, 2) | (expandColumn(twice >> 8, 2) << 16);
 		}
-		line >>= 1;
-	}
+		default:
+			return line;
 	}
-	return OLED_Success;
+}
+
+/*!
+	@brief Marks a screen area as changed for the next partial update
+	@param x x start coordinate
+	@param y y start coordinate
+	@param w width of the area
+	@param h height of the area
+	@note Does nothing here, a sub-class that can send part of the screen
+		overrides it. Drawing functions do not call it, widgets that know
+		what they changed do.
+*/
+void SSD1306_graphics::markDirty(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+	(void)x; (void)y; (void)w; (void)h;
+}
+
+/*!
+	@brief Limits drawing to a rectangle, pixels outside it are discarded
+	@param x x start coordinate
+	@param y y start coordinate
+	@param w width of the rectangle
+	@param h height of the rectangle
+	@note The rectangle is trimmed to the screen. Rotation resets it.
+*/
+void SSD1306_graphics::setClipRect(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+	_clipX0 = (x < 0) ? 0 : x;
+	_clipY0 = (y < 0) ? 0 : y;
+	_clipX1 = (x + w > _width) ? _width : x + w;
+	_clipY1 = (y + h > _height) ? _height : y + h;
+	if (_clipX1 < _clipX0) _clipX1 = _clipX0;
+	if (_clipY1 < _clipY0) _clipY1 = _clipY0;
+}
+
+/*!
+	@brief Resets the clip rectangle to the whole screen
+*/
+void SSD1306_graphics::clearClipRect(void)
+{
+	_clipX0 = 0;
+	_clipY0 = 0;
+	_clipX1 = _width;
+	_clipY1 = _height;
+}
+
+/*!
+	@brief Gets the clip rectangle
+	@return current clip rectangle, the whole screen when none is set
+*/
+OLEDRect_t SSD1306_graphics::getClipRect(void) const
+{
+	return OLEDRect_t{_clipX0, _clipY0, (int16_t)(_clipX1 - _clipX0), (int16_t)(_clipY1 - _clipY0)};
 }
 
 /*! 
@@ -617,8 +824,159 @@ void SSD1306_graphics::setRotation(OLED_rotate_e CurrentRotation) {
 			_height = WIDTH;
 			break;
 	}
+	clearClipRect();
+}
+
+
+/*!
+	@brief Gets the current font number
+	@return font number 1-12 , see OLEDFontType_e
+*/
+uint8_t SSD1306_graphics::getFontNum(void) const {return _FontNumber;}
+
+/*!
+	@brief Gets the current text size
+	@return text size 1-X , only used by fonts 1-6
+*/
+uint8_t SSD1306_graphics::getTextSize(void) const {return _textSize;}
+
+/*!
+	@brief Gets the horizontal cursor advance per character
+	@return advance in pixels for the current font and text size
+	@note fonts 1-6 include the blank padding column and are scaled by text size
+*/
+int16_t SSD1306_graphics::getCharAdvance(void) const
+{
+	if (_FontNumber < OLEDFont_Bignum)
+		return _textSize*(_CurrentFontWidth+1);
+	return _CurrentFontWidth;
+}
+
+/*!
+	@brief Gets the vertical cursor advance per line
+	@return line height in pixels for the current font and text size
+*/
+int16_t SSD1306_graphics::getLineHeight(void) const
+{
+	if (_FontNumber < OLEDFont_Bignum)
+		return _textSize*_CurrentFontheight;
+	return _CurrentFontheight;
+}
+
+/*!
+	@brief Gets the x position past which write() wraps to a new line
+	@return wrap limit in pixels
+*/
+int16_t SSD1306_graphics::wrapLimit(void) const
+{
+	if (_FontNumber < OLEDFont_Bignum)
+		return _width - getCharAdvance();
+	return _width - (_CurrentFontWidth+1);
+}
+
+/*!
+	@brief Checks if a character is within the ASCII range of the current font
+	@param character The ASCII character
+	@return true if the current font holds a glyph for the character
+*/
+bool SSD1306_graphics::charInFont(uint8_t character) const
+{
+	return !(character < _CurrentFontoffset || character >= (_CurrentFontLength+ _CurrentFontoffset));
+}
+
+/*!
+	@brief Gets the glyph data of a character in the current font
+	@param character The ASCII character
+	@return pointer to glyph data or nullptr if not in the font.
+		Fonts 1-6 : width bytes, one per column.
+		Fonts 7-12 : width * (height/8) bytes , column by column MSB first.
+*/
+const uint8_t* SSD1306_graphics::getGlyph(uint8_t character) const
+{
+	if (!charInFont(character))
+		return nullptr;
+	uint16_t index = character - _CurrentFontoffset;
+	switch (_FontNumber)
+	{
+		case OLEDFont_Default : return pFontDefaultptr + (index * _CurrentFontWidth);
+		case OLEDFont_Thick : return pFontThickptr + (index * _CurrentFontWidth);
+		case OLEDFont_SevenSeg: return pFontSevenSegptr + (index * _CurrentFontWidth);
+		case OLEDFont_Wide : return pFontWideptr + (index * _CurrentFontWidth);
+		case OLEDFont_Tiny : return pFontTinyptr + (index * _CurrentFontWidth);
+		case OLEDFont_Homespun : return pFontHomeSpunptr + (index * _CurrentFontWidth);
+		case OLEDFont_Bignum: return pFontBigNumptr[index];
+		case OLEDFont_Mednum: return pFontMedNumptr[index];
+		case OLEDFont_ArialRound: return pFontArial16x24ptr[index];
+		case OLEDFont_ArialBold: return pFontArial16x16ptr[index];
+		case OLEDFont_Mia: return pFontMia8x16ptr[index];
+		case OLEDFont_Dedica: return pFontDedica8x12ptr[index];
+		default: return nullptr;
+	}
 }
 
+/*!
+	@brief Measures a null terminated string without drawing it
+	@param pText pointer to string of ASCII character's
+	@return OLEDTextMetrics_t width, height and line count
+*/
+OLEDTextMetrics_t SSD1306_graphics::measureText(const char *pText)
+{
+	if (pText == nullptr)
+		return OLEDTextMetrics_t{0, 0, 0};
+	return measureText(pText, strlen(pText));
+}
+
+/*!
+	@brief Measures text without drawing it
+	@param pText pointer to array of ASCII character's
+	@param length number of characters to measure
+	@return OLEDTextMetrics_t width, height and line count
+	@details Uses the same advance, newline and wrap rules as write() for the
+		current font, text size and wrap setting, with the text starting at the
+		left edge. '\n' always starts a new line, a wrap only counts
+		when another character follows it. Characters outside the font range
+		are skipped as write() does not advance the cursor for them.
+*/
+OLEDTextMetrics_t SSD1306_graphics::measureText(const char *pText, size_t length)
+{
+	OLEDTextMetrics_t metrics{0, 0, 0};
+	if (pText == nullptr || length == 0)
+		return metrics;
+
+	const int16_t advance = getCharAdvance();
+	const int16_t limit = wrapLimit();
+	int16_t lineWidth = 0;
+	bool wrapPending = false;
+	metrics.lines = 1;
+
+	for (size_t i = 0; i < length; i++)
+	{
+		uint8_t character = pText[i];
+		if (character == '\r')
+			continue;
+		if (character == '\n')
+		{
+			lineWidth = 0;
+			wrapPending = false;
+			metrics.lines++;
+			continue;
+		}
+		if (!charInFont(character))
+			continue;
+		if (wrapPending)
+		{
+			lineWidth = 0;
+			wrapPending = false;
+			metrics.lines++;
+		}
+		lineWidth += advance;
+		if (lineWidth > metrics.width) metrics.width = lineWidth;
+		if (_textwrap && lineWidth > limit)
+			wrapPending = true;
+	}
+	metrics.height = metrics.lines * getLineHeight();
+	return metrics;
+}
 
 /*!
 	@brief   Set the current font type
@@ -721,83 +1079,32 @@ void SSD1306_graphics::setFontNum(OLEDFontType_e FontNumber)
 	@return OLED_Return_Codes_e
 	@note for font 7-12 only
 */
-OLED_Return_Codes_e SSD1306_graphics::drawChar(uint8_t x, uint8_t y, uint8_t character, uint8_t color , uint8_t bg) 
+OLED_Return_Codes_e SSD1306_graphics::drawChar(int16_t x, int16_t y, uint8_t character, uint8_t color , uint8_t bg) 
 {
-	uint8_t FontSizeMod = 0;
 	// Check user input
 	// 1. Check for wrong font
-	switch (_FontNumber)
+	if (_FontNumber < OLEDFont_Bignum)
 	{
-		case OLEDFont_Bignum:
-		case OLEDFont_Mednum:
-		case OLEDFont_ArialRound:
-		case OLEDFont_ArialBold:
-			FontSizeMod  = 2;
-		break;
-		case OLEDFont_Mia:
-		case OLEDFont_Dedica:
-			FontSizeMod  = 1;
-		break;
-		default:
-			printf("Error drawChar 4: Wrong font selected, must be font 7-12: %u \r\n",  OLED_WrongFont);
-			return OLED_WrongFont;
-		break;
+		OLED_ERROR(OLED_WrongFont, "drawChar 4", "Wrong font selected, must be font 7-12: %u \r\n",  OLED_WrongFont);
+		return OLED_WrongFont;
 	}
 	// 2. Check for character out of font bounds
-	if ( character < _CurrentFontoffset || character >= (_CurrentFontLength+ _CurrentFontoffset))
+	if (!charInFont(character))
 	{
-		printf("Error drawChar 3: Character out of Font bounds : %u :  %u  %u<->%u \r\n",OLED_CharFontASCIIRange, character,_CurrentFontoffset, (_CurrentFontLength + _CurrentFontoffset));
+		OLED_ERROR(OLED_CharFontASCIIRange, "drawChar 3", "Character out of Font bounds : %u :  %u  %u<->%u \r\n",OLED_CharFontASCIIRange, character,_CurrentFontoffset, (_CurrentFontLength + _CurrentFontoffset));
 		return OLED_CharFontASCIIRange;
 	}
 	// 3. Check for screen out of  bounds
 	if((x >= _width)            || // Clip right
-	(y >= _height)           || // Clip bottom
-	((x + _CurrentFontWidth+1) < 0) || // Clip left
-	((y + _CurrentFontheight) < 0))   // Clip top
+	(y >= _height)              || // Clip bottom
+	((x + _CurrentFontWidth - 1) < 0)   || // Clip left
+	((y + _CurrentFontheight - 1) < 0))    // Clip top
 	{
-		printf( "Error drawChar 3: Co-ordinates out of bounds: %u  \r\n", OLED_CharScreenBounds);
+		OLED_ERROR(OLED_CharScreenBounds, "drawChar 3", "Co-ordinates out of bounds: %u  \r\n", OLED_CharScreenBounds);
 		return OLED_CharScreenBounds;
 	}
-	
-	uint8_t i, j;
-	uint8_t ctemp = 0, y0 = y; 
-
-	for (i = 0; i < _CurrentFontheight*FontSizeMod; i++) 
-	{
-		switch (_FontNumber)
-		{
-			case OLEDFont_Bignum: ctemp = pFontBigNumptr[character - _CurrentFontoffset][i]; break;
-			case OLEDFont_Mednum: ctemp = pFontMedNumptr[character - _CurrentFontoffset][i]; break;
-			case OLEDFont_ArialRound: ctemp = pFontArial16x24ptr[character - _CurrentFontoffset][i]; break;
-			case OLEDFont_ArialBold: ctemp = pFontArial16x16ptr[character - _CurrentFontoffset][i]; break;
-			case OLEDFont_Mia: ctemp = pFontMia8x16ptr[character - _CurrentFontoffset][i]; break;
-			case OLEDFont_Dedica: ctemp = pFontDedica8x12ptr[character - _CurrentFontoffset][i]; break;
-			default :
-				printf("Error drawChar 4: Wrong font selected, must be font 7-12 : %u\r\n",  OLED_WrongFont);
-				return OLED_WrongFont;
-			break;
-		}
-		
-		for (j = 0; j < 8; j++) 
-		{
-			if (ctemp & 0x80) 
-			{
-				drawPixel(x, y, color);
-			} else 
-			{
-				drawPixel(x, y, bg);
-			}
 
-			ctemp <<= 1;
-			y++;
-			if ((y - y0) == _CurrentFontheight) 
-			{
-				y = y0;
-				x++;
-				break;
-			}
-		}
-	}
+	renderGlyph(x, y, getGlyph(character), color, bg, 1);
 	return OLED_Success;
 }
 
@@ -811,20 +1118,20 @@ OLED_Return_Codes_e SSD1306_graphics::drawChar(uint8_t x, uint8_t y, uint8_t cha
 	@return OLED_Return_Codes_e enum
 	@note for font 7-12 only
 */
-OLED_Return_Codes_e SSD1306_graphics::drawText(uint8_t x, uint8_t y, char *pText, uint8_t color, uint8_t bg)
+OLED_Return_Codes_e SSD1306_graphics::drawText(int16_t x, int16_t y, char *pText, uint8_t color, uint8_t bg)
 {
 	OLED_Return_Codes_e DrawCharReturnCode;
 	// Check correct font number
 	if (_FontNumber < OLEDFont_Bignum)
 	{
-		printf("Error drawText 1 :Wrong font selected, must be 7 -12: %u \n",  OLED_WrongFont);
+		OLED_ERROR(OLED_WrongFont, "drawText 1", "Wrong font selected, must be 7 -12: %u \n",  OLED_WrongFont);
 		return OLED_WrongFont;
 	}
 
 	// Check for null pointer
 	if(pText == nullptr)
 	{
-		printf("Error drawText 2 :String array is not valid pointer: %u \n", OLED_CharArrayNullptr);
+		OLED_ERROR(OLED_CharArrayNullptr, "drawText 2", "String array is not valid pointer: %u \n", OLED_CharArrayNullptr);
 		return OLED_CharArrayNullptr;
 	}
 
@@ -842,7 +1149,7 @@ OLED_Return_Codes_e SSD1306_graphics::drawText(uint8_t x, uint8_t y, char *pText
 		DrawCharReturnCode = drawChar(x, y, *pText, color, bg);
 		if(DrawCharReturnCode  != OLED_Success)
 		{
-			printf("Error drawText 3: Method drawChar failed: %u\n", DrawCharReturnCode);
+			OLED_TRACE("drawText 3", "Method drawChar failed: %u\n", DrawCharReturnCode);
 			return DrawCharReturnCode;
 		}
 		x += _CurrentFontWidth ;
@@ -863,23 +1170,23 @@ OLED_Return_Codes_e SSD1306_graphics::drawText(uint8_t x, uint8_t y, char *pText
 	@return OLED_Return_Codes_e enum
 	@note for font #1-6 only
 */
-OLED_Return_Codes_e SSD1306_graphics::drawText(uint8_t x, uint8_t y, char *pText, uint8_t color, uint8_t bg, uint8_t size) 
+OLED_Return_Codes_e SSD1306_graphics::drawText(int16_t x, int16_t y, char *pText, uint8_t color, uint8_t bg, uint8_t size) 
 {
 	// check Correct font number
 	if (_FontNumber >= OLEDFont_Bignum)
 	{
-		printf("Error drawText 1: Wrong font number , must be 1-6 %u\n", OLED_WrongFont);
+		OLED_ERROR(OLED_WrongFont, "drawText 1", "Wrong font number , must be 1-6 %u\n", OLED_WrongFont);
 		return OLED_WrongFont;
 	}
 	// Check for null pointer
 	if(pText == nullptr)
 	{
-		printf("Error drawText 2: String array is not valid pointer: %u \n", OLED_CharArrayNullptr);
+		OLED_ERROR(OLED_CharArrayNullptr, "drawText 2", "String array is not valid pointer: %u \n", OLED_CharArrayNullptr);
 		return OLED_CharArrayNullptr;
 	}
 	OLED_Return_Codes_e DrawCharReturnCode;
-	uint8_t lcursor_x = x; 
-	uint8_t lcursor_y = y;
+	int16_t lcursor_x = x; 
+	int16_t lcursor_y = y;
 
 	while (*pText != '\0') 
 	{
@@ -892,7 +1199,7 @@ OLED_Return_Codes_e SSD1306_graphics::drawText(uint8_t x, uint8_t y, char *pText
 		DrawCharReturnCode = drawChar(lcursor_x, lcursor_y, *pText, color, bg, size);
 		if (DrawCharReturnCode != OLED_Success)
 		{
-			printf("Error drawText 3: Method drawChar failed: %u\n", DrawCharReturnCode);
+			OLED_TRACE("drawText 3", "Method drawChar failed: %u\n", DrawCharReturnCode);
 			return DrawCharReturnCode;
 		};
 		lcursor_x = lcursor_x + size * (_CurrentFontWidth + 1);
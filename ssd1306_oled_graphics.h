@@ -15,27 +15,11 @@
 #include <cmath> // for "abs"
 #include "ssd1306_oled_print.h"
 #include "ssd1306_oled_font.h"
+#include "ssd1306_oled_error.h"
 
 #define swapOLEDRPI(a, b) { int16_t t = a; a = b; b = t; }
 
 
-/*! Enum to define return codes from some text and bitmap functions  */
-enum OLED_Return_Codes_e : uint8_t
-{
-	OLED_Success = 0,                /**< Success!*/
-	OLED_WrongFont = 2,              /**< Wrong Font selected for this method, There are two families of font included with different overloaded functions*/
-	OLED_CharScreenBounds = 3,       /**< Text Character is out of Screen bounds, Check x and y*/
-	OLED_CharFontASCIIRange = 4,     /**< Text Character is outside of chosen Fonts ASCII range, Check the selected Fonts ASCII range.*/
-	OLED_CharArrayNullptr = 5,       /**< Text Character Array is an invalid pointer object*/
-	OLED_BitmapNullptr = 7,          /**< The Bitmap data array is an invalid pointer object*/
-	OLED_BitmapScreenBounds = 8,     /**< The bitmap starting point is outside screen bounds check x and y*/
-	OLED_BitmapLargerThanScreen = 9, /**< The Bitmap is larger than screen, check  w and h*/
-	OLED_BitmapVerticalSize = 10,    /**< A vertical Bitmap's height must be divisible by 8. */
-	OLED_BitmapHorizontalSize = 11,  /**< A horizontal Bitmap's width  must be divisible by 8  */
-	OLED_BitmapSize = 12,            /**< Size of the Bitmap is incorrect: BitmapSize(vertical)!=(w*(h/8),BitmapSize(horizontal)!=(w/8)*h*/
-	OLED_CustomCharLen = 13          /**< CustomChar array must always be 5 bytes long*/
-};
-
 /*! Enum to hold current screen rotation in degrees  */
 enum OLED_rotate_e : uint8_t
 {
@@ -62,6 +46,23 @@ enum OLEDFontType_e : uint8_t
 	OLEDFont_Dedica = 12       /**< dedica font */
 };
 
+/*! @brief Struct to hold the bounds of a string as returned by measureText */
+struct OLEDTextMetrics_t
+{
+	int16_t width;   /**< Width of the widest line in pixels */
+	int16_t height;  /**< Height of all lines in pixels */
+	uint16_t lines;  /**< Number of lines the text occupies */
+};
+
+/*! @brief Struct to hold a screen rectangle, empty when w or h is 0 or less */
+struct OLEDRect_t
+{
+	int16_t x; /**< Left edge */
+	int16_t y; /**< Top edge */
+	int16_t w; /**< Width in pixels */
+	int16_t h; /**< Height in pixels */
+};
+
 /*! @brief Graphics class to hold graphic related functions */
 class SSD1306_graphics : public Print{
 
@@ -71,6 +72,8 @@ class SSD1306_graphics : public Print{
 
 	// Graphic related member functions 
 	virtual void drawPixel(int16_t x, int16_t y, uint8_t color) = 0;
+	virtual void drawColumnBits(int16_t x, int16_t y, uint32_t bits, uint8_t height,
+	  uint8_t color, uint8_t bg);
 
 	void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t color);
 	void drawFastVLine(int16_t x, int16_t y, int16_t h, uint8_t color);
@@ -94,6 +97,10 @@ class SSD1306_graphics : public Print{
 	  int16_t radius, uint8_t color);
 
 	// Screen related member functions 
+	virtual void markDirty(int16_t x, int16_t y, int16_t w, int16_t h);
+	void setClipRect(int16_t x, int16_t y, int16_t w, int16_t h);
+	void clearClipRect(void);
+	OLEDRect_t getClipRect(void) const;
 	void setCursor(int16_t x, int16_t y);
 	void setRotation(OLED_rotate_e m);
 	OLED_rotate_e getRotation();
@@ -101,10 +108,12 @@ class SSD1306_graphics : public Print{
 	int16_t width(void) const;
 	
 	// Text & font related member functions 
+	using Print::write;
 	virtual size_t write(uint8_t);
-	OLED_Return_Codes_e drawChar(uint8_t x, uint8_t y, uint8_t c, uint8_t color ,uint8_t bg);
-	OLED_Return_Codes_e drawText(uint8_t x, uint8_t y, char *pText, uint8_t color, uint8_t bg);
-	OLED_Return_Codes_e drawText(uint8_t x, uint8_t y, char *pText, uint8_t color, uint8_t bg, uint8_t size);
+	virtual size_t write(const uint8_t *buffer, size_t size) override;
+	OLED_Return_Codes_e drawChar(int16_t x, int16_t y, uint8_t c, uint8_t color ,uint8_t bg);
+	OLED_Return_Codes_e drawText(int16_t x, int16_t y, char *pText, uint8_t color, uint8_t bg);
+	OLED_Return_Codes_e drawText(int16_t x, int16_t y, char *pText, uint8_t color, uint8_t bg, uint8_t size);
 	OLED_Return_Codes_e drawChar(int16_t x, int16_t y, unsigned char c, uint8_t color,
 	  uint8_t bg, uint8_t size);
 	void setTextColor(uint8_t c);
@@ -112,6 +121,13 @@ class SSD1306_graphics : public Print{
 	void setTextSize(uint8_t s);
 	void setTextWrap(bool w);
 	void setFontNum(OLEDFontType_e FontNumber);
+	uint8_t getFontNum(void) const;
+	uint8_t getTextSize(void) const;
+	int16_t getCharAdvance(void) const;
+	int16_t getLineHeight(void) const;
+	OLEDTextMetrics_t measureText(const char *pText);
+	OLEDTextMetrics_t measureText(const char *pText, size_t length);
+	const uint8_t* getGlyph(uint8_t character) const;
 
  protected:
 	
@@ -127,6 +143,15 @@ class SSD1306_graphics : public Print{
 	uint8_t _textBgColor;   /**< Text background color */
 	uint8_t   _textSize = 1; /**< Size of text ,fonts 1-6 */
 	bool _textwrap;          /**< If set, '_textwrap' text at right edge of display*/
+	int16_t _clipX0 = 0;     /**< Clip rectangle left edge, drawing outside is discarded */
+	int16_t _clipY0 = 0;     /**< Clip rectangle top edge */
+	int16_t _clipX1;         /**< Clip rectangle right edge, exclusive */
+	int16_t _clipY1;         /**< Clip rectangle bottom edge, exclusive */
+
+	bool charInFont(uint8_t character) const;
+	int16_t wrapLimit(void) const;
+	static uint32_t expandColumn(uint8_t line, uint8_t size);
+	void renderGlyph(int16_t x, int16_t y, const uint8_t* pGlyph, uint8_t color, uint8_t bg, uint8_t size);
 	
 private:
 
@@ -0,0 +1,201 @@
+/*!
+	@file ssd1306_oled_i2ctx.cpp
+	@brief OLED driven by SSD1306 controller. Source file
+		for the interrupt driven I2C transmitter.
+*/
+
+#include "ssd1306_oled_i2ctx.h"
+
+#if PICO_ON_DEVICE // needs the I2C controller registers
+
+#define OLED_TX_FIFO_LEVEL 4 /**< TX_EMPTY fires at or below this many bytes in the FIFO */
+
+OLEDI2CTransmitter *OLEDI2CTransmitter::_pActive[2] = {nullptr, nullptr};
+
+/*!
+	@brief Installs the interrupt handler and becomes the transport of the display
+	@param oled display, OLEDbegin must have been called
+	@return false if the I2C controller already has a transmitter
+*/
+bool OLEDI2CTransmitter::begin(SSD1306 &oled)
+{
+	uint index = i2c_hw_index(oled.OLEDGetI2C());
+	if (_pActive[index] != nullptr && _pActive[index] != this)
+	{
+		OLED_ERROR(OLED_TransferState, "i2ctx begin 1", "I2C controller %u has a transmitter already\r\n", index);
+		return false;
+	}
+	oled.OLEDWaitIdle();
+	_pOled = &oled;
+	_pI2C = oled.OLEDGetI2C();
+	_pActive[index] = this;
+	_state = OLEDTx_Idle;
+	_bytes = 0;
+
+	i2c_get_hw(_pI2C)->intr_mask = 0;
+	uint irqNum = I2C0_IRQ + index;
+	irq_set_exclusive_handler(irqNum, (index == 0) ? irq0Handler : irq1Handler);
+	irq_set_enabled(irqNum, true);
+	oled.OLEDSetTransport(this);
+	return true;
+}
+
+/*!
+	@brief Waits for the transfer in progress and returns the display to blocking updates
+*/
+void OLEDI2CTransmitter::end(void)
+{
+	if (_pOled == nullptr) return;
+	_pOled->OLEDSetTransport(nullptr); // waits for the transfer
+	uint index = i2c_hw_index(_pI2C);
+	irq_set_enabled(I2C0_IRQ + index, false);
+	i2c_get_hw(_pI2C)->intr_mask = 0;
+	_pActive[index] = nullptr;
+	_pOled = nullptr;
+}
+
+/*!
+	@brief Sets a function called from the interrupt when a transfer ends
+	@param callback function , nullptr for none
+	@param pContext user pointer passed to the function
+*/
+void OLEDI2CTransmitter::setCallback(OLEDTxCallback_t callback, void *pContext)
+{
+	_callback = callback;
+	_pContext = pContext;
+}
+
+/*!
+	@brief Gets the state of the last transfer
+	@return OLEDTxState_e
+*/
+OLEDTxState_e OLEDI2CTransmitter::poll(void) const {return _state;}
+
+/*!
+	@brief Gets the number of bytes loaded into the FIFO since begin
+	@return byte count including control bytes
+*/
+uint32_t OLEDI2CTransmitter::bytesSent(void) const {return _bytes;}
+
+/*!
+	@brief Starts a transfer, called by the display
+	@param oled display with a prepared transfer
+	@return false if the display is not the one served, it then sends blocking
+*/
+bool OLEDI2CTransmitter::startTransfer(SSD1306 &oled)
+{
+	if (&oled != _pOled) return false;
+	if (!oled.OLEDMuxSelect()) // the channel switch is written blocking while the bus is free
+	{
+		oled.OLEDTxEnd();
+		_state = OLEDTx_Error;
+		return true;
+	}
+	_more = oled.OLEDTxNextSegment(_segment, UINT16_MAX);
+	if (!_more)
+	{
+		oled.OLEDTxEnd();
+		_state = OLEDTx_Done;
+		return true;
+	}
+	_segmentPos = 0;
+	_state = OLEDTx_Busy;
+
+	i2c_hw_t *hw = i2c_get_hw(_pI2C);
+	hw->enable = 0;
+	hw->tar = oled.OLEDGetAddress();
+	hw->enable = 1;
+	hw->tx_tl = OLED_TX_FIFO_LEVEL;
+	(void)hw->clr_stop_det;
+	(void)hw->clr_tx_abrt;
+	hw->intr_mask = I2C_IC_INTR_MASK_M_TX_EMPTY_BITS | I2C_IC_INTR_MASK_M_STOP_DET_BITS |
+		I2C_IC_INTR_MASK_M_TX_ABRT_BITS; // TX_EMPTY fires at once and loads the FIFO
+	return true;
+}
+
+/*!
+	@brief Waits for the transfer on the bus to end , called by the display
+	@param oled display about to send a blocking transaction
+*/
+void OLEDI2CTransmitter::waitBusFree(SSD1306 &oled)
+{
+	if (oled.OLEDGetI2C() != _pI2C) return;
+	while (_state == OLEDTx_Busy) tight_loop_contents();
+}
+
+/*!
+	@brief Interrupt work: refills the FIFO and detects the end , used internally
+*/
+void OLEDI2CTransmitter::service(void)
+{
+	i2c_hw_t *hw = i2c_get_hw(_pI2C);
+	uint32_t status = hw->intr_stat;
+	if (status & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS)
+	{
+		(void)hw->clr_tx_abrt;
+		finish(OLED_TransferAbort);
+		return;
+	}
+	bool stopped = false;
+	if (status & I2C_IC_RAW_INTR_STAT_STOP_DET_BITS)
+	{
+		(void)hw->clr_stop_det;
+		stopped = true;
+	}
+
+	while (_more && i2c_get_write_available(_pI2C) > 0)
+	{
+		uint8_t value = (_segmentPos == 0) ? _segment.control : _segment.pData[_segmentPos - 1];
+		bool last = (_segmentPos == _segment.length);
+		hw->data_cmd = value | (last ? I2C_IC_DATA_CMD_STOP_BITS : 0);
+		_bytes++;
+		_segmentPos++;
+		if (last)
+		{
+			_segmentPos = 0;
+			_more = _pOled->OLEDTxNextSegment(_segment, UINT16_MAX);
+		}
+	}
+	if (!_more)
+	{
+		hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+		// STOPs of several segments may be seen as one, so check the controller is done
+		uint32_t idle = hw->status & (I2C_IC_STATUS_TFE_BITS | I2C_IC_STATUS_ACTIVITY_BITS);
+		if (stopped && idle == I2C_IC_STATUS_TFE_BITS) finish(OLED_Success);
+	}
+}
+
+/*!
+	@brief Ends the transfer and reports it , used internally
+	@param result OLED_Success or OLED_TransferAbort
+*/
+void OLEDI2CTransmitter::finish(OLED_Return_Codes_e result)
+{
+	i2c_get_hw(_pI2C)->intr_mask = 0;
+	_more = false;
+	_pOled->OLEDTxEnd();
+	if (result != OLED_Success)
+		OLEDReportError(result, "i2ctx finish 1"); // counted only, no printf in the interrupt
+	_state = (result == OLED_Success) ? OLEDTx_Done : OLEDTx_Error;
+	if (_callback != nullptr) _callback(result, _pContext);
+}
+
+/*!
+	@brief Interrupt handler of I2C0 , used internally
+*/
+void OLEDI2CTransmitter::irq0Handler(void)
+{
+	if (_pActive[0] != nullptr && _pActive[0]->_state == OLEDTx_Busy) _pActive[0]->service();
+	else i2c_get_hw(i2c0)->intr_mask = 0;
+}
+
+/*!
+	@brief Interrupt handler of I2C1 , used internally
+*/
+void OLEDI2CTransmitter::irq1Handler(void)
+{
+	if (_pActive[1] != nullptr && _pActive[1]->_state == OLEDTx_Busy) _pActive[1]->service();
+	else i2c_get_hw(i2c1)->intr_mask = 0;
+}
+
+#endif
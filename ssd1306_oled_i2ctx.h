@@ -0,0 +1,75 @@
+/*!
+	@file ssd1306_oled_i2ctx.h
+	@brief OLED driven by SSD1306 controller. header file
+		for the interrupt driven I2C transmitter.
+	@details Sends updates in the background without DMA. The TX_EMPTY
+		interrupt of the I2C controller refills the transmit FIFO straight from
+		the frame buffer, segment by segment as produced by
+		OLEDTxNextSegment, so each control byte, window and page is framed by
+		the same state machine as a blocking update. Each segment ends with a
+		STOP, the transfer is complete at a STOP once every segment is loaded,
+		the FIFO is empty and the controller is idle.
+*/
+
+#pragma once
+
+#include "ssd1306_oled.h"
+#include "hardware/irq.h"
+
+/*! Enum to define the state of the transmitter as returned by poll */
+enum OLEDTxState_e : uint8_t
+{
+	OLEDTx_Idle = 0,  /**< No transfer started since begin */
+	OLEDTx_Busy = 1,  /**< Transfer in progress */
+	OLEDTx_Done = 2,  /**< Last transfer complete */
+	OLEDTx_Error = 3  /**< Last transfer aborted, the display did not acknowledge */
+};
+
+/*!
+	@brief completion callback, runs in the I2C interrupt
+	@param result OLED_Success or OLED_TransferAbort
+	@param pContext user pointer passed to setCallback
+*/
+typedef void (*OLEDTxCallback_t)(OLED_Return_Codes_e result, void *pContext);
+
+/*!
+	@brief class to send display transfers from the I2C interrupt
+	@details After begin, OLEDupdate and OLEDupdateDirty of the display return
+		as soon as the transfer is started. Check completion with poll() or
+		OLEDIsBusy, or get called back from the interrupt.
+	@note One transmitter per I2C controller. Other devices on the same bus
+		must not be accessed while a transfer runs. Device builds only.
+*/
+class OLEDI2CTransmitter : public OLEDTxTransport
+{
+  public:
+	OLEDI2CTransmitter(){};
+
+	bool begin(SSD1306 &oled);
+	void end(void);
+	void setCallback(OLEDTxCallback_t callback, void *pContext);
+	OLEDTxState_e poll(void) const;
+	uint32_t bytesSent(void) const;
+
+	virtual bool startTransfer(SSD1306 &oled) override;
+	virtual void waitBusFree(SSD1306 &oled) override;
+
+  private:
+
+	void service(void);
+	void finish(OLED_Return_Codes_e result);
+	static void irq0Handler(void);
+	static void irq1Handler(void);
+
+	SSD1306 *_pOled = nullptr;        /**< Display served */
+	i2c_inst *_pI2C = nullptr;        /**< I2C instance of the display */
+	OLEDTxSegment_t _segment{};       /**< Segment being loaded into the FIFO */
+	uint16_t _segmentPos = 0;         /**< Next byte of segment, 0 is the control byte */
+	bool _more = false;               /**< Segment holds bytes not loaded yet */
+	volatile uint32_t _bytes = 0;     /**< Bytes loaded since begin */
+	volatile OLEDTxState_e _state = OLEDTx_Idle; /**< State reported by poll */
+	OLEDTxCallback_t _callback = nullptr; /**< Completion callback */
+	void *_pContext = nullptr;        /**< Callback user pointer */
+
+	static OLEDI2CTransmitter *_pActive[2]; /**< Transmitter per I2C controller */
+};
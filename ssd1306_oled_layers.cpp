@@ -0,0 +1,260 @@
+/*!
+	@file ssd1306_oled_layers.cpp
+	@brief OLED driven by SSD1306 controller. Source file
+		for the layer compositor.
+*/
+
+#include "ssd1306_oled_layers.h"
+
+/*!
+	@brief Adds a layer on top of the existing ones, it starts visible
+	@param pBuffer pointer to layer buffer
+	@param sizeOfBuffer size of buffer , must be width * (height/8)
+	@param pMask pointer to mask buffer of the same size or nullptr
+	@return layer number, -1 on failure
+	@note The first layer added is selected for drawing.
+*/
+int8_t OLEDCompositor::addLayer(uint8_t *pBuffer, uint16_t sizeOfBuffer, uint8_t *pMask)
+{
+	if (_count >= OLED_MAX_LAYERS)
+	{
+		OLED_ERROR(OLED_LayerInvalid, "layer add 1", "All %u layers in use\r\n", OLED_MAX_LAYERS);
+		return -1;
+	}
+	if (pBuffer == nullptr)
+	{
+		OLED_ERROR(OLED_BufferNullptr, "layer add 2", "Layer buffer is not a valid pointer object\r\n");
+		return -1;
+	}
+	if (_width > OLED_LAYER_MAX_WIDTH)
+	{
+		OLED_ERROR(OLED_BufferSize, "layer add 4", "Layer width %u over %u\r\n", _width, OLED_LAYER_MAX_WIDTH);
+		return -1;
+	}
+	if (sizeOfBuffer != _width * (_height / 8))
+	{
+		OLED_ERROR(OLED_BufferSize, "layer add 3", "buffer size does not equal : width * (height/8))\n");
+		return -1;
+	}
+	OLEDLayer_t &layer = _layers[_count];
+	layer.pBuffer = pBuffer;
+	layer.pMask = pMask;
+	layer.bounds = OLEDRect_t{0, 0, _oled.width(), _oled.height()};
+	layer.visible = true;
+	if (_count == 0) _oled.OLEDSetBufferPtr(_width, _height, pBuffer, sizeOfBuffer);
+	return _count++;
+}
+
+/*!
+	@brief Gets the number of layers
+	@return layer count
+*/
+uint8_t OLEDCompositor::layers(void) const {return _count;}
+
+/*!
+	@brief Points the display at a layer, following drawing goes into it
+	@param layer layer number
+	@return false if layer does not exist
+*/
+bool OLEDCompositor::selectLayer(uint8_t layer)
+{
+	if (layer >= _count)
+	{
+		OLED_ERROR(OLED_LayerInvalid, "layer select 1", "Layer does not exist: %u\r\n", layer);
+		return false;
+	}
+	return _oled.OLEDSetBufferPtr(_width, _height, _layers[layer].pBuffer, _width * (_height / 8));
+}
+
+/*!
+	@brief Points the display at the mask of a layer, drawing WHITE makes pixels opaque
+	@param layer layer number
+	@return false if layer does not exist or has no mask
+	@note Changing a mask does not mark anything dirty, call markDirty for the area.
+*/
+bool OLEDCompositor::selectMask(uint8_t layer)
+{
+	if (layer >= _count || _layers[layer].pMask == nullptr)
+	{
+		OLED_ERROR(OLED_LayerInvalid, "layer select 2", "Layer does not exist or has no mask: %u\r\n", layer);
+		return false;
+	}
+	return _oled.OLEDSetBufferPtr(_width, _height, _layers[layer].pMask, _width * (_height / 8));
+}
+
+/*!
+	@brief Shows or hides a layer, its bounds are marked dirty
+	@param layer layer number
+	@param visible true take part in the composite
+	@return false if layer does not exist
+*/
+bool OLEDCompositor::setLayerVisible(uint8_t layer, bool visible)
+{
+	if (layer >= _count)
+	{
+		OLED_ERROR(OLED_LayerInvalid, "layer visible 1", "Layer does not exist: %u\r\n", layer);
+		return false;
+	}
+	if (_layers[layer].visible == visible) return true;
+	_layers[layer].visible = visible;
+	const OLEDRect_t &b = _layers[layer].bounds;
+	_oled.markDirty(b.x, b.y, b.w, b.h);
+	return true;
+}
+
+/*!
+	@brief Checks if a layer takes part in the composite
+	@param layer layer number
+	@return true if visible
+*/
+bool OLEDCompositor::isLayerVisible(uint8_t layer) const
+{
+	return (layer < _count) && _layers[layer].visible;
+}
+
+/*!
+	@brief Sets the area a layer draws in, redrawn when it is shown or hidden
+	@param layer layer number
+	@param x x start coordinate
+	@param y y start coordinate
+	@param w width of the area
+	@param h height of the area
+	@return false if layer does not exist
+	@note Defaults to the whole screen. Coordinates follow the current rotation.
+*/
+bool OLEDCompositor::setLayerBounds(uint8_t layer, int16_t x, int16_t y, int16_t w, int16_t h)
+{
+	if (layer >= _count)
+	{
+		OLED_ERROR(OLED_LayerInvalid, "layer bounds 1", "Layer does not exist: %u\r\n", layer);
+		return false;
+	}
+	_layers[layer].bounds = OLEDRect_t{x, y, w, h};
+	return true;
+}
+
+/*!
+	@brief Composites the areas marked dirty on the display and sends them
+	@details One window per run of pages with the same changed columns, as
+		OLEDupdateDirty. The dirty areas are cleared.
+	@note Sent blocking after the transfer in progress on the display, also
+		when a transport is set. Refused while the display is double buffered
+		or page flipping, the composite has no back buffer or hidden bank.
+*/
+void OLEDCompositor::flush(void)
+{
+	if (_oled.OLEDIsDoubleBuffered() || _oled.OLEDIsPageFlip())
+	{
+		OLED_ERROR(OLED_ModeConflict, "layer flush 1", "Not with double buffering or page flipping\r\n");
+		return;
+	}
+	_oled.OLEDWaitIdle();
+	uint32_t line[(OLED_LAYER_MAX_WIDTH / 4) + 1]; // one page span, one spare word for alignment
+	uint8_t pages = _height / 8;
+	uint8_t page = 0;
+	while (page < pages)
+	{
+		uint8_t x0, x1;
+		if (!_oled.OLEDGetDirty(page, x0, x1)) {page++; continue;}
+		uint8_t last = page;
+		uint8_t nx0, nx1;
+		while (last + 1 < pages && _oled.OLEDGetDirty(last + 1, nx0, nx1) && nx0 == x0 && nx1 == x1) last++;
+
+		_oled.OLEDSetWindow(x0, x1, page, last);
+		for (; page <= last; page++)
+		{
+			uint16_t offset = (_width * page) + x0;
+			// same word phase as the layer buffers
+			uint8_t *pOut = (uint8_t *)line + (offset & 3);
+			composite(offset, x1 - x0 + 1, pOut);
+			_oled.OLEDWriteData(pOut, x1 - x0 + 1);
+		}
+	}
+	_oled.OLEDClearDirty();
+}
+
+/*!
+	@brief Composites and sends the whole screen
+*/
+void OLEDCompositor::flushAll(void)
+{
+	_oled.markDirty(0, 0, _oled.width(), _oled.height());
+	flush();
+}
+
+/*!
+	@brief Combines the visible layers for a run of bytes , used internally
+	@param offset byte offset in the layer buffers
+	@param length number of bytes
+	@param pOut destination
+*/
+void OLEDCompositor::composite(uint16_t offset, uint8_t length, uint8_t *pOut) const
+{
+	bool base = true;
+	for (uint8_t i = 0; i < _count; i++)
+	{
+		const OLEDLayer_t &layer = _layers[i];
+		if (!layer.visible) continue;
+		if (base)
+		{
+			memcpy(pOut, layer.pBuffer + offset, length);
+			base = false;
+		}
+		else
+			compositeSpan(pOut, layer.pBuffer + offset,
+				(layer.pMask != nullptr) ? layer.pMask + offset : nullptr, length);
+	}
+	if (base) memset(pOut, 0x00, length);
+}
+
+/*!
+	@brief Puts one layer over a run of bytes , used internally
+	@param pDst composite so far
+	@param pSrc layer bytes
+	@param pMask mask bytes or nullptr
+	@param length number of bytes
+	@details Works on 32 bit words when all pointers share the word phase,
+		which holds for word aligned buffers. The words are uint32_t locals
+		filled and stored with memcpy, which keeps to strict aliasing.
+*/
+void OLEDCompositor::compositeSpan(uint8_t *pDst, const uint8_t *pSrc, const uint8_t *pMask, uint8_t length)
+{
+	uintptr_t phase = (uintptr_t)pDst & 3;
+	bool words = (((uintptr_t)pSrc & 3) == phase) && (pMask == nullptr || ((uintptr_t)pMask & 3) == phase);
+	uint8_t i = 0;
+	if (words)
+	{
+		// bytes up to the first word boundary
+		for (; i < length && (((uintptr_t)(pDst + i)) & 3); i++)
+			pDst[i] = pMask ? (uint8_t)((pDst[i] & ~pMask[i]) | (pSrc[i] & pMask[i])) : (pDst[i] | pSrc[i]);
+		// words through memcpy , not through uint32_t pointers to the uint8_t buffers.
+		// All three are word aligned here, so each copy is one load or store
+		uint8_t *pDstWord = (uint8_t *)__builtin_assume_aligned(pDst + i, 4);
+		const uint8_t *pSrcWord = (const uint8_t *)__builtin_assume_aligned(pSrc + i, 4);
+		uint32_t dst, src, mask;
+		if (pMask != nullptr)
+		{
+			const uint8_t *pMaskWord = (const uint8_t *)__builtin_assume_aligned(pMask + i, 4);
+			for (; i + 4 <= length; i += 4, pDstWord += 4, pSrcWord += 4, pMaskWord += 4)
+			{
+				memcpy(&dst, pDstWord, 4);
+				memcpy(&src, pSrcWord, 4);
+				memcpy(&mask, pMaskWord, 4);
+				dst = (dst & ~mask) | (src & mask);
+				memcpy(pDstWord, &dst, 4);
+			}
+		}
+		else
+		{
+			for (; i + 4 <= length; i += 4, pDstWord += 4, pSrcWord += 4)
+			{
+				memcpy(&dst, pDstWord, 4);
+				memcpy(&src, pSrcWord, 4);
+				dst |= src;
+				memcpy(pDstWord, &dst, 4);
+			}
+		}
+	}
+	for (; i < length; i++)
+		pDst[i] = pMask ? (uint8_t)((pDst[i] & ~pMask[i]) | (pSrc[i] & pMask[i])) : (pDst[i] | pSrc[i]);
+}
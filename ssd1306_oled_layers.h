@@ -0,0 +1,70 @@
+/*!
+	@file ssd1306_oled_layers.h
+	@brief OLED driven by SSD1306 controller. header file
+		for the layer compositor.
+	@details Keeps up to OLED_MAX_LAYERS screen buffers, for example background,
+		content and overlay. The display object draws into one selected layer
+		at a time and records the changed areas as usual. flush() combines the
+		layers for the changed areas only, a word at a time, straight into the
+		I2C data stream. Showing or hiding an overlay costs a composite of its
+		area, the layers below are not redrawn.
+*/
+
+#pragma once
+
+#include "ssd1306_oled.h"
+
+#ifndef OLED_MAX_LAYERS
+#define OLED_MAX_LAYERS 4 /**< Maximum number of layers in one compositor */
+#endif
+
+#define OLED_LAYER_MAX_WIDTH 128 /**< Widest layer, the columns of display RAM */
+
+/*!
+	@brief class to composite several screen buffers at update time
+	@details Layer 0 is the bottom. The lowest visible layer is copied as is.
+		A layer above it without a mask adds its set pixels, with a mask it
+		replaces the pixels below wherever its mask bit is set.
+	@note Buffers and masks are in the same page format as the display buffer,
+		width * (height/8) bytes, at most OLED_LAYER_MAX_WIDTH wide. Word
+		aligned buffers are composited a word at a time. Use flush() instead
+		of OLEDupdate and OLEDupdateDirty. flush() sends blocking, so it can
+		not be used with double buffering or page flipping.
+*/
+class OLEDCompositor
+{
+  public:
+	OLEDCompositor(SSD1306 &oled, uint8_t width, uint8_t height) :
+		_oled(oled), _width(width), _height(height) {};
+
+	int8_t addLayer(uint8_t *pBuffer, uint16_t sizeOfBuffer, uint8_t *pMask = nullptr);
+	uint8_t layers(void) const;
+	bool selectLayer(uint8_t layer);
+	bool selectMask(uint8_t layer);
+	bool setLayerVisible(uint8_t layer, bool visible);
+	bool isLayerVisible(uint8_t layer) const;
+	bool setLayerBounds(uint8_t layer, int16_t x, int16_t y, int16_t w, int16_t h);
+
+	void flush(void);
+	void flushAll(void);
+
+  private:
+
+	/*! @brief one layer */
+	struct OLEDLayer_t
+	{
+		uint8_t *pBuffer;   /**< Layer pixels */
+		uint8_t *pMask;     /**< Opaque pixels , nullptr = set pixels only */
+		OLEDRect_t bounds;  /**< Area redrawn when shown or hidden */
+		bool visible;       /**< Layer takes part in the composite */
+	};
+
+	void composite(uint16_t offset, uint8_t length, uint8_t *pOut) const;
+	static void compositeSpan(uint8_t *pDst, const uint8_t *pSrc, const uint8_t *pMask, uint8_t length);
+
+	SSD1306 &_oled;                          /**< Display the layers are drawn with and sent to */
+	uint8_t _width;                          /**< Width of layer buffers in pixels */
+	uint8_t _height;                         /**< Height of layer buffers in pixels */
+	OLEDLayer_t _layers[OLED_MAX_LAYERS];    /**< Layers, 0 = bottom */
+	uint8_t _count = 0;                      /**< Number of layers added */
+};
@@ -0,0 +1,89 @@
+/*!
+	@file ssd1306_oled_mux.cpp
+	@brief OLED driven by SSD1306 controller. Source file
+		for the I2C multiplexer.
+*/
+
+#include "ssd1306_oled_mux.h"
+
+/*!
+	@brief Opens one channel , nothing is written if it is open already
+	@param channel 0-7
+	@return false if the channel is out of range or the multiplexer did not acknowledge
+*/
+bool OLEDI2CMux::select(uint8_t channel)
+{
+	if (channel >= OLED_MUX_CHANNELS)
+	{
+		OLED_ERROR(OLED_MuxSelect, "mux select 1", "Channel %u out of range\r\n", channel);
+		return false;
+	}
+	if (channel == _channel) return true;
+	if (!writeControl(1 << channel)) return false;
+	_channel = channel;
+	return true;
+}
+
+/*!
+	@brief Closes all channels
+	@return false if the multiplexer did not acknowledge
+*/
+bool OLEDI2CMux::deselect(void)
+{
+	if (!writeControl(0)) return false;
+	_channel = OLED_MUX_NONE;
+	return true;
+}
+
+/*!
+	@brief Forgets the open channel , the next select writes the control register
+*/
+void OLEDI2CMux::invalidate(void)
+{
+	_channel = OLED_MUX_NONE;
+	_pOwner = nullptr;
+}
+
+/*!
+	@brief Gets the open channel
+	@return 0-7 , OLED_MUX_NONE if none or unknown
+*/
+uint8_t OLEDI2CMux::channel(void) const {return _channel;}
+
+/*!
+	@brief Gets the number of control register writes
+	@return count since construction or resetSwitches
+*/
+uint32_t OLEDI2CMux::switches(void) const {return _switches;}
+
+/*! @brief Resets the count of control register writes */
+void OLEDI2CMux::resetSwitches(void) {_switches = 0;}
+
+/*! @brief Gets the bus of the multiplexer @return i2c0 or i2c1 */
+i2c_inst* OLEDI2CMux::getI2C(void) const {return _pI2C;}
+
+/*! @brief Gets the I2C address of the multiplexer @return address */
+uint8_t OLEDI2CMux::getAddress(void) const {return _address;}
+
+/*! @brief Gets the display that opened the channel last @return display , nullptr if none */
+SSD1306* OLEDI2CMux::owner(void) const {return _pOwner;}
+
+/*! @brief Sets the display that opened the channel @param pOwner display , set by SSD1306::OLEDMuxSelect */
+void OLEDI2CMux::setOwner(SSD1306 *pOwner) {_pOwner = pOwner;}
+
+/*!
+	@brief Writes the channel mask , used internally
+	@param control one bit per channel
+	@return false if the multiplexer did not acknowledge , the channel is then unknown
+*/
+bool OLEDI2CMux::writeControl(uint8_t control)
+{
+	_switches++;
+	if (i2c_write_blocking(_pI2C, _address, &control, 1, false) != 1)
+	{
+		_channel = OLED_MUX_NONE;
+		OLED_ERROR(OLED_MuxSelect, "mux writeControl 1", "No acknowledge from 0x%02X\r\n", _address);
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,60 @@
+/*!
+	@file ssd1306_oled_mux.h
+	@brief OLED driven by SSD1306 controller. header file
+		for the I2C multiplexer.
+	@details Drives a TCA9548A style I2C switch so several displays with the
+		same address can share one bus. The channel selected last is
+		remembered and a switch is only written when a display on another
+		channel is addressed.
+*/
+
+#pragma once
+
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "ssd1306_oled_error.h"
+
+#define OLED_MUX_ADDR 0x70      /**< I2C address of the multiplexer, 0x70-0x77 by its A0-A2 pins */
+#define OLED_MUX_CHANNELS 8     /**< Downstream channels of the multiplexer */
+#define OLED_MUX_NONE 0xFF      /**< No channel selected or channel unknown */
+
+class SSD1306;
+
+/*!
+	@brief class for a TCA9548A style I2C multiplexer
+	@details Give it to each display behind it with SSD1306::OLEDSetMux. The
+		display selects its channel before every transaction, the bus
+		scheduler also groups its chunks by channel.
+	@note One channel is open at a time. Call invalidate after other code
+		wrote the control register so the next select writes it again.
+		The display that opened the channel last is its owner, a blocking
+		write of another display first waits until the transport of the
+		owner has nothing on the bus, so a switch never cuts into a transfer.
+*/
+class OLEDI2CMux
+{
+  public:
+	OLEDI2CMux(i2c_inst *i2c, uint8_t address = OLED_MUX_ADDR) : _pI2C(i2c), _address(address) {};
+
+	bool select(uint8_t channel);
+	bool deselect(void);
+	void invalidate(void);
+
+	uint8_t channel(void) const;
+	uint32_t switches(void) const;
+	void resetSwitches(void);
+	i2c_inst* getI2C(void) const;
+	uint8_t getAddress(void) const;
+	SSD1306* owner(void) const;
+	void setOwner(SSD1306 *pOwner);
+
+  private:
+
+	bool writeControl(uint8_t control);
+
+	i2c_inst *_pI2C;                   /**< Bus the multiplexer is on */
+	uint8_t _address;                  /**< I2C address of the multiplexer */
+	uint8_t _channel = OLED_MUX_NONE;  /**< Channel open now */
+	uint32_t _switches = 0;            /**< Control register writes since reset */
+	SSD1306 *_pOwner = nullptr;        /**< Display that opened the channel last */
+};
@@ -0,0 +1,154 @@
+/*!
+	@file ssd1306_oled_pacer.cpp
+	@brief OLED driven by SSD1306 controller. Source file
+		for the frame pacer.
+*/
+
+#include "ssd1306_oled_pacer.h"
+
+/*!
+	@brief Sets the highest update rate
+	@param fps frames per second, 0 sends every request at the next service
+*/
+void OLEDFramePacer::setTargetFps(uint16_t fps)
+{
+	_intervalUs = (fps == 0) ? 0 : 1000000UL / fps;
+}
+
+/*!
+	@brief Caps the share of bus time used by the display
+	@param percent 1-100, after an update taking t the next waits t * (100 - percent) / percent
+*/
+void OLEDFramePacer::setBusShare(uint8_t percent)
+{
+	if (percent < 1) percent = 1;
+	if (percent > 100) percent = 100;
+	_busShare = percent;
+}
+
+/*!
+	@brief Asks for an update of the areas marked dirty
+	@param maxDelayUs latest time from now the update should start, 0 follow the frame rate
+	@note The bus share is kept even when a deadline is missed.
+*/
+void OLEDFramePacer::request(uint32_t maxDelayUs)
+{
+	uint64_t now = time_us_64();
+	if (_statsStart == 0) _statsStart = now;
+	if (maxDelayUs != 0 && (_deadline == 0 || now + maxDelayUs < _deadline))
+		_deadline = now + maxDelayUs;
+	_pending = true;
+	_pendingRequests++;
+	_stats.requests++;
+}
+
+/*!
+	@brief Marks an area dirty and asks for an update
+	@param x x start coordinate
+	@param y y start coordinate
+	@param w width of the area
+	@param h height of the area
+	@param maxDelayUs latest time from now the update should start, 0 follow the frame rate
+*/
+void OLEDFramePacer::request(int16_t x, int16_t y, int16_t w, int16_t h, uint32_t maxDelayUs)
+{
+	_oled.markDirty(x, y, w, h);
+	request(maxDelayUs);
+}
+
+/*!
+	@brief Sends an update if one is due, call it often from the main loop
+	@return true if an update was started
+	@details Due when a request waits, the bus share allows it and either the
+		frame interval has passed or a deadline is reached.
+*/
+bool OLEDFramePacer::service(void)
+{
+	uint64_t now = time_us_64();
+	if (_sending)
+	{
+		if (_oled.OLEDIsBusy()) return false;
+		finishFrame(now);
+	}
+	if (!_pending || now < _busFreeAt) return false;
+	bool rateDue = (_lastFrame == 0) || (now - _lastFrame >= _intervalUs);
+	bool deadlineDue = (_deadline != 0) && (now >= _deadline);
+	if (!rateDue && !deadlineDue) return false;
+	if (_oled.OLEDIsBusy()) return false; // sent by someone else
+
+	if (_deadline != 0 && now > _deadline) _stats.deadlineMisses++;
+	_stats.frames++;
+	_stats.coalesced += _pendingRequests - 1;
+	_pending = false;
+	_pendingRequests = 0;
+	_deadline = 0;
+	_lastFrame = now;
+	_sendStart = now;
+
+	if (_oled.OLEDIsDirty()) _oled.OLEDupdateDirty();
+	else _oled.OLEDupdate();
+
+	_sending = true;
+	if (!_oled.OLEDIsBusy()) finishFrame(time_us_64());
+	return true;
+}
+
+/*!
+	@brief Checks for a request waiting for an update
+	@return true if an update will be sent
+*/
+bool OLEDFramePacer::isPending(void) const {return _pending;}
+
+/*!
+	@brief Gets the counters
+	@return copy of the counters, elapsedUs up to now
+*/
+OLEDPacerStats_t OLEDFramePacer::stats(void)
+{
+	if (_statsStart != 0) _stats.elapsedUs = time_us_64() - _statsStart;
+	return _stats;
+}
+
+/*!
+	@brief Gets the update rate since the counters were reset
+	@return frames per second
+*/
+uint16_t OLEDFramePacer::achievedFps(void)
+{
+	OLEDPacerStats_t current = stats();
+	if (current.elapsedUs == 0) return 0;
+	return (uint16_t)((current.frames * 1000000ULL) / current.elapsedUs);
+}
+
+/*!
+	@brief Gets the share of time spent sending since the counters were reset
+	@return percent 0-100
+*/
+uint8_t OLEDFramePacer::busDutyPercent(void)
+{
+	OLEDPacerStats_t current = stats();
+	if (current.elapsedUs == 0) return 0;
+	uint64_t percent = (current.busyUs * 100) / current.elapsedUs;
+	return (percent > 100) ? 100 : (uint8_t)percent;
+}
+
+/*!
+	@brief Sets all counters to 0 and starts a new measurement
+*/
+void OLEDFramePacer::resetStats(void)
+{
+	_stats = OLEDPacerStats_t{};
+	_statsStart = time_us_64();
+}
+
+/*!
+	@brief Books the time of the update sent , used internally
+	@param now time the update was seen finished
+*/
+void OLEDFramePacer::finishFrame(uint64_t now)
+{
+	uint64_t busy = now - _sendStart;
+	_stats.busyUs += busy;
+	_busFreeAt = now + (busy * (100 - _busShare)) / _busShare;
+	_sending = false;
+}
@@ -0,0 +1,68 @@
+/*!
+	@file ssd1306_oled_pacer.h
+	@brief OLED driven by SSD1306 controller. header file
+		for the frame pacer.
+	@details Application code asks for a frame whenever something changes,
+		the pacer coalesces those requests and their dirty areas and sends at
+		most one update per frame interval. A request may carry a deadline
+		that is met ahead of the frame rate. The share of bus time the display
+		takes can be capped to leave room for other devices on the bus.
+*/
+
+#pragma once
+
+#include "ssd1306_oled.h"
+
+/*! @brief Struct to hold frame pacer counters */
+struct OLEDPacerStats_t
+{
+	uint32_t requests;       /**< Calls to request */
+	uint32_t frames;         /**< Updates sent */
+	uint32_t coalesced;      /**< Requests merged into an update with others, frames skipped */
+	uint32_t deadlineMisses; /**< Updates sent after the deadline of a request */
+	uint64_t busyUs;         /**< Time spent sending */
+	uint64_t elapsedUs;      /**< Time since the counters were reset */
+};
+
+/*!
+	@brief class to pace display updates to a frame rate and a bus share
+	@details Call request when the picture changed, after markDirty or with the
+		area, and service from the main loop. service sends one update when a
+		frame is due. With nothing marked dirty the whole frame is sent.
+	@note With a transport the time until OLEDIsBusy turns false is counted
+		as bus time.
+*/
+class OLEDFramePacer
+{
+  public:
+	OLEDFramePacer(SSD1306 &oled) : _oled(oled) {};
+
+	void setTargetFps(uint16_t fps);
+	void setBusShare(uint8_t percent);
+	void request(uint32_t maxDelayUs = 0);
+	void request(int16_t x, int16_t y, int16_t w, int16_t h, uint32_t maxDelayUs = 0);
+	bool service(void);
+	bool isPending(void) const;
+
+	OLEDPacerStats_t stats(void);
+	uint16_t achievedFps(void);
+	uint8_t busDutyPercent(void);
+	void resetStats(void);
+
+  private:
+
+	void finishFrame(uint64_t now);
+
+	SSD1306 &_oled;                 /**< Display paced */
+	uint32_t _intervalUs = 33333;   /**< Minimum time between updates, 30 fps */
+	uint8_t _busShare = 100;        /**< Largest share of bus time in percent */
+	bool _pending = false;          /**< A request waits for an update */
+	bool _sending = false;          /**< An update is sent by a transport */
+	uint32_t _pendingRequests = 0;  /**< Requests merged into the waiting update */
+	uint64_t _deadline = 0;         /**< Earliest deadline of waiting requests, 0 none */
+	uint64_t _lastFrame = 0;        /**< Start time of the last update */
+	uint64_t _sendStart = 0;        /**< Start time of the update being sent */
+	uint64_t _busFreeAt = 0;        /**< Earliest next update allowed by the bus share */
+	uint64_t _statsStart = 0;       /**< Time the counters were reset */
+	OLEDPacerStats_t _stats{};      /**< Counters */
+};
@@ -7,6 +7,12 @@
 
 #include "ssd1306_oled_print.h"
 
+// Powers of ten for the integer number formatting, index is the exponent
+static const uint32_t PrintPow10[10] = {
+  1UL, 10UL, 100UL, 1000UL, 10000UL,
+  100000UL, 1000000UL, 10000000UL, 100000000UL, 1000000000UL
+};
+
 // Public Methods //////////////////////////
 
 /* default implementation: may be overridden */
@@ -46,12 +52,7 @@ size_t Print::print(long n, int base)
   if (base == 0) {
     return write(n);
   } else if (base == 10) {
-    if (n < 0) {
-      int t = print('-');
-      n = -n;
-      return printNumber(n, 10) + t;
-    }
-    return printNumber(n, 10);
+    return printPadded(n, 0);
   } else {
     return printNumber(n, base);
   }
@@ -68,6 +69,64 @@ size_t Print::print(double n, int digits)
   return printFloat(n, digits);
 }
 
+/*!
+  @brief print a decimal integer right aligned in a field
+  @param n number to print
+  @param width minimum number of characters , max PRINT_FIELD_WIDTH_MAX
+  @param pad fill character, '0' pads between the sign and the digits
+  @return number of characters written
+*/
+size_t Print::printPadded(long n, uint8_t width, char pad)
+{
+  bool negative = n < 0;
+  unsigned long magnitude = negative ? (0UL - (unsigned long)n) : (unsigned long)n;
+  if (magnitude > 0xFFFFFFFFUL) {
+    if (negative) print('-');
+    return printNumber(magnitude, 10) + negative;
+  }
+  return printDecimal(negative, magnitude, 0, 0, width, pad);
+}
+
+/*!
+  @brief print a floating point number right aligned in a field
+  @param n number to print
+  @param digits number of decimal places 0-9
+  @param width minimum number of characters , max PRINT_FIELD_WIDTH_MAX
+  @param pad fill character, '0' pads between the sign and the digits
+  @return number of characters written
+*/
+size_t Print::printFloatPadded(double n, uint8_t digits, uint8_t width, char pad)
+{
+  return printFloat(n, digits, width, pad);
+}
+
+/*!
+  @brief print a fixed point number without any floating point arithmetic
+  @param value signed fixed point value , real value is value / 2^fracBits
+  @param fracBits number of fractional bits 0-31 e.g. 8 for Q23.8
+  @param digits number of decimal places 0-9 , rounded
+  @param width minimum number of characters , max PRINT_FIELD_WIDTH_MAX
+  @param pad fill character, '0' pads between the sign and the digits
+  @return number of characters written
+*/
+size_t Print::printFixed(int32_t value, uint8_t fracBits, uint8_t digits, uint8_t width, char pad)
+{
+  if (fracBits > 31) fracBits = 31;
+  if (digits > 9) digits = 9;
+
+  bool negative = value < 0;
+  uint32_t magnitude = negative ? (0UL - (uint32_t)value) : (uint32_t)value;
+  uint32_t intPart = magnitude >> fracBits;
+  uint64_t frac = magnitude & ((1ULL << fracBits) - 1);
+  uint64_t half = fracBits ? (1ULL << (fracBits - 1)) : 0;
+  uint32_t fracPart = (uint32_t)((frac * PrintPow10[digits] + half) >> fracBits);
+  if (fracPart >= PrintPow10[digits]) {
+    intPart++;
+    fracPart -= PrintPow10[digits];
+  }
+  return printDecimal(negative, intPart, fracPart, digits, width, pad);
+}
+
 size_t Print::println(void)
 {
   return write("\r\n");
@@ -124,6 +183,7 @@ size_t Print::println(double num, int digits)
   return n;
 }
 
+#ifndef PRINT_NO_STD_STRING
 size_t Print::print(const std::string &s) {
     return write(s.c_str(), s.length());
 }
@@ -133,6 +193,27 @@ size_t Print::println(const std::string &s) {
     n += println();
     return n;
 }
+#endif
+
+/*!
+  @brief printf style formatted output in a single write call
+  @param format printf format string, checked at compile time
+  @return number of characters written
+  @note Formats into a PRINT_PRINTF_BUFFER_SIZE stack buffer, longer output
+    is truncated. No heap is used with the pico-sdk default printf
+    implementation (pico_printf), newlib may allocate for floating point.
+*/
+size_t Print::oledPrintf(const char *format, ...)
+{
+  char buffer[PRINT_PRINTF_BUFFER_SIZE];
+  va_list args;
+  va_start(args, format);
+  int len = vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  if (len <= 0) return 0;
+  if ((size_t)len >= sizeof(buffer)) len = sizeof(buffer) - 1;
+  return write(buffer, len);
+}
 
 // Private Methods /////////////////////////////////////////////////////////////
 
@@ -146,9 +227,22 @@ size_t Print::printNumber(unsigned long n, uint8_t base)
   // prevent crash if called with base == 1
   if (base < 2) base = 10;
 
+  if (base == 10 && n <= 0xFFFFFFFFUL) {
+    uint8_t len = formatDecimal(buf, n, 1);
+    return write(buf, len);
+  }
+
+  // power of two bases shift and mask, others divide
+  uint8_t shift = (base == 2) ? 1 : (base == 8) ? 3 : (base == 16) ? 4 : 0;
   do {
-    char c = n % base;
-    n /= base;
+    char c;
+    if (shift) {
+      c = n & (base - 1);
+      n >>= shift;
+    } else {
+      c = n % base;
+      n /= base;
+    }
 
     *--str = c < 10 ? c + '0' : c + 'A' - 10;
   } while(n);
@@ -156,47 +250,93 @@ size_t Print::printNumber(unsigned long n, uint8_t base)
   return write(str);
 }
 
-size_t Print::printFloat(double number, uint8_t digits) 
+/*!
+  @brief convert an unsigned number to decimal digits
+  @param buf destination, at least 10 characters, not terminated
+  @param n number to convert
+  @param minDigits minimum number of digits, leading zeros are added, 1-10
+  @return number of characters written
+  @note Digits come from repeated subtraction of powers of ten, no division.
+*/
+uint8_t Print::formatDecimal(char *buf, uint32_t n, uint8_t minDigits)
+{
+  uint8_t len = 0;
+  for (int8_t e = 9; e >= 0; e--) {
+    char digit = '0';
+    while (n >= PrintPow10[e]) {
+      n -= PrintPow10[e];
+      digit++;
+    }
+    if (digit != '0' || len || e < minDigits) buf[len++] = digit;
+  }
+  return len;
+}
+
+/*!
+  @brief print integer and fractional part as one padded field
+  @param negative print a minus sign
+  @param intPart integer part
+  @param fracPart fractional part already scaled by 10^digits
+  @param digits number of decimal places, 0 prints no decimal point
+  @param width minimum number of characters
+  @param pad fill character
+  @return number of characters written
+*/
+size_t Print::printDecimal(bool negative, uint32_t intPart, uint32_t fracPart, uint8_t digits, uint8_t width, char pad)
+{
+  char body[24];
+  uint8_t len = formatDecimal(body, intPart, 1);
+  if (digits > 0) {
+    body[len++] = '.';
+    len += formatDecimal(body + len, fracPart, digits);
+  }
+  return writeField(negative, body, len, width, pad);
+}
+
+/*!
+  @brief write sign, padding and digits in a single write call
+  @param negative print a minus sign
+  @param body digits to print
+  @param len number of digits
+  @param width minimum number of characters , capped at PRINT_FIELD_WIDTH_MAX
+  @param pad fill character, '0' goes between the sign and the digits
+  @return number of characters written
+*/
+size_t Print::writeField(bool negative, const char *body, uint8_t len, uint8_t width, char pad)
+{
+  char out[PRINT_FIELD_WIDTH_MAX + 24];
+  uint8_t n = 0;
+  if (width > PRINT_FIELD_WIDTH_MAX) width = PRINT_FIELD_WIDTH_MAX;
+  uint8_t total = len + (negative ? 1 : 0);
+  uint8_t padding = (width > total) ? (width - total) : 0;
+
+  if (negative && pad == '0') out[n++] = '-';
+  while (padding--) out[n++] = pad;
+  if (negative && pad != '0') out[n++] = '-';
+  memcpy(out + n, body, len);
+  return write(out, n + len);
+}
+
+size_t Print::printFloat(double number, uint8_t digits, uint8_t width, char pad) 
 { 
-  size_t n = 0;
-  
   if (std::isnan(number)) return print("nan");
   if (std::isinf(number)) return print("inf");
   if (number > 4294967040.0) return print ("ovf");  // constant determined empirically
   if (number <-4294967040.0) return print ("ovf");  // constant determined empirically
-  
+
   // Handle negative numbers
-  if (number < 0.0)
-  {
-     n += print('-');
-     number = -number;
-  }
+  bool negative = number < 0.0;
+  if (negative) number = -number;
+  if (digits > 9) digits = 9;
 
+  // Scale the fraction to an integer once, instead of a double op per digit.
   // Round correctly so that print(1.999, 2) prints as "2.00"
-  double rounding = 0.5;
-  for (uint8_t i=0; i<digits; ++i)
-    rounding /= 10.0;
-  
-  number += rounding;
-
-  // Extract the integer part of the number and print it
-  unsigned long int_part = (unsigned long)number;
+  uint32_t int_part = (uint32_t)number;
   double remainder = number - (double)int_part;
-  n += print(int_part);
-
-  // Print the decimal point, but only if there are digits beyond
-  if (digits > 0) {
-    n += print('.'); 
+  uint32_t frac_part = (uint32_t)(remainder * PrintPow10[digits] + 0.5);
+  if (frac_part >= PrintPow10[digits]) {
+    int_part++;
+    frac_part -= PrintPow10[digits];
   }
-
-  // Extract digits from the remainder one at a time
-  while (digits-- > 0)
-  {
-    remainder *= 10.0;
-    unsigned int toPrint = (unsigned int)(remainder);
-    n += print(toPrint);
-    remainder -= toPrint; 
-  } 
-  
-  return n;
+  return printDecimal(negative, int_part, frac_part, digits, width, pad);
 }
@@ -11,7 +11,10 @@
 #include <cstdio> // for size_t
 #include <cstring>
 #include <cmath>
+#include <cstdarg>
+#ifndef PRINT_NO_STD_STRING
 #include <string>
+#endif
 
 #define DEC 10
 #define HEX 16
@@ -21,6 +24,12 @@
 #endif
 #define BIN 2
 
+#define PRINT_FIELD_WIDTH_MAX 32 /**< Widest field printPadded and printFixed will pad to */
+
+#ifndef PRINT_PRINTF_BUFFER_SIZE
+#define PRINT_PRINTF_BUFFER_SIZE 64 /**< Stack buffer for oledPrintf, longer output is truncated */
+#endif
+
 /*!
 	@brief class that provides polymorphic print methods for printing data
 */
@@ -29,7 +38,10 @@ class Print
   private:
     int write_error;
     size_t printNumber(unsigned long, uint8_t);
-    size_t printFloat(double, uint8_t);
+    size_t printFloat(double, uint8_t, uint8_t = 0, char = ' ');
+    size_t printDecimal(bool, uint32_t, uint32_t, uint8_t, uint8_t, char);
+    size_t writeField(bool, const char *, uint8_t, uint8_t, char);
+    static uint8_t formatDecimal(char *, uint32_t, uint8_t);
   protected:
     void setWriteError(int err = 1) { write_error = err; }
   public:
@@ -59,7 +71,14 @@ class Print
     size_t print(long, int = DEC);
     size_t print(unsigned long, int = DEC);
     size_t print(double, int = 2);
+#ifndef PRINT_NO_STD_STRING
     size_t print(const std::string &);
+#endif
+
+    size_t printPadded(long, uint8_t, char = ' ');
+    size_t printFloatPadded(double, uint8_t, uint8_t, char = ' ');
+    size_t printFixed(int32_t, uint8_t, uint8_t, uint8_t = 0, char = ' ');
+    size_t oledPrintf(const char *format, ...) __attribute__((format(printf, 2, 3)));
 
     size_t println(const char[]);
     size_t println(char);
@@ -69,5 +88,7 @@ class Print
     size_t println(unsigned long, int = DEC);
     size_t println(double, int = 2);
     size_t println(void);
+#ifndef PRINT_NO_STD_STRING
     size_t println(const std::string &s);
+#endif
 };
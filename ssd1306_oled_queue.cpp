@@ -0,0 +1,317 @@
+/*!
+	@file ssd1306_oled_queue.cpp
+	@brief OLED driven by SSD1306 controller. Source file
+		for the multi producer draw command queue.
+*/
+
+#include "ssd1306_oled_queue.h"
+
+/*!
+	@brief Sets the slot ring and empties the queue
+	@param pSlots pointer to array of slots
+	@param count number of slots
+	@return true for success, false if the array is not valid
+	@note Call before any producer runs.
+*/
+bool OLEDDrawQueue::begin(OLEDQueueSlot_t *pSlots, uint16_t count)
+{
+	if (pSlots == nullptr || count == 0)
+	{
+		OLED_ERROR(OLED_BufferNullptr, "queue begin 1", "Slot array is not valid pointer or has no slots\r\n");
+		return false;
+	}
+#if PICO_ON_DEVICE
+	if (_pLock == nullptr)
+		_pLock = spin_lock_instance(spin_lock_claim_unused(true));
+#endif
+	_pSlots = pSlots;
+	_count = count;
+	for (uint16_t i = 0; i < count; i++)
+		_pSlots[i].ready = 0;
+	_head = 0;
+	_tail = 0;
+	_dropped = 0;
+	return true;
+}
+
+/*!
+	@brief Reserves the next slot , used internally
+	@return pointer to slot, nullptr if the queue is full
+*/
+OLEDQueueSlot_t *OLEDDrawQueue::reserve(void)
+{
+	if (_pSlots == nullptr) return nullptr;
+#if PICO_ON_DEVICE
+	uint32_t saved = spin_lock_blocking(_pLock);
+	uint32_t head = _head;
+	bool full = (head - _tail) >= _count;
+	if (full)
+		_dropped = _dropped + 1;
+	else
+		_head = head + 1;
+	spin_unlock(_pLock, saved);
+	if (full) return nullptr;
+#else
+	uint32_t head = _head.load(std::memory_order_relaxed);
+	do
+	{
+		if ((head - _tail.load(std::memory_order_acquire)) >= _count)
+		{
+			_dropped.fetch_add(1, std::memory_order_relaxed);
+			return nullptr;
+		}
+	} while (!_head.compare_exchange_weak(head, head + 1, std::memory_order_relaxed));
+#endif
+	return &_pSlots[head % _count];
+}
+
+/*!
+	@brief Queues a prepared op
+	@param op op, for example recorded into a one op display list
+	@return false if the queue is full
+	@note Text and bitmap data of op are referenced, use drawText to queue a copy of a string.
+*/
+bool OLEDDrawQueue::push(const OLEDDrawOp_t &op)
+{
+	OLEDQueueSlot_t *pSlot = reserve();
+	if (pSlot == nullptr) return false;
+	pSlot->op = op;
+#if PICO_ON_DEVICE
+	__dmb();
+	pSlot->ready = 1;
+#else
+	pSlot->ready.store(1, std::memory_order_release);
+#endif
+	return true;
+}
+
+/*!
+	@brief Queues a pixel
+	@param x x coordinate
+	@param y y coordinate
+	@param color color of pixel
+	@return false if the queue is full
+*/
+bool OLEDDrawQueue::drawPixel(int16_t x, int16_t y, uint8_t color)
+{
+	OLEDDrawOp_t op;
+	OLEDDisplayList one;
+	one.begin(&op, 1);
+	one.drawPixel(x, y, color);
+	return push(op);
+}
+
+/*!
+	@brief Queues a line
+	@param x0 start x coordinate
+	@param y0 start y coordinate
+	@param x1 end x coordinate
+	@param y1 end y coordinate
+	@param color color of line
+	@return false if the queue is full
+*/
+bool OLEDDrawQueue::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t color)
+{
+	OLEDDrawOp_t op;
+	OLEDDisplayList one;
+	one.begin(&op, 1);
+	one.drawLine(x0, y0, x1, y1, color);
+	return push(op);
+}
+
+/*!
+	@brief Queues a rectangle outline
+	@param x x start coordinate
+	@param y y start coordinate
+	@param w width of the rectangle
+	@param h height of the rectangle
+	@param color color of rectangle
+	@return false if the queue is full
+*/
+bool OLEDDrawQueue::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color)
+{
+	OLEDDrawOp_t op;
+	OLEDDisplayList one;
+	one.begin(&op, 1);
+	one.drawRect(x, y, w, h, color);
+	return push(op);
+}
+
+/*!
+	@brief Queues a filled rectangle
+	@param x x start coordinate
+	@param y y start coordinate
+	@param w width of the rectangle
+	@param h height of the rectangle
+	@param color color of rectangle
+	@return false if the queue is full
+*/
+bool OLEDDrawQueue::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color)
+{
+	OLEDDrawOp_t op;
+	OLEDDisplayList one;
+	one.begin(&op, 1);
+	one.fillRect(x, y, w, h, color);
+	return push(op);
+}
+
+/*!
+	@brief Queues a circle outline
+	@param x0 circle center x position
+	@param y0 circle center y position
+	@param r radius of circle
+	@param color color of circle
+	@return false if the queue is full
+*/
+bool OLEDDrawQueue::drawCircle(int16_t x0, int16_t y0, int16_t r, uint8_t color)
+{
+	OLEDDrawOp_t op;
+	OLEDDisplayList one;
+	one.begin(&op, 1);
+	one.drawCircle(x0, y0, r, color);
+	return push(op);
+}
+
+/*!
+	@brief Queues a filled circle
+	@param x0 circle center x position
+	@param y0 circle center y position
+	@param r radius of circle
+	@param color color of circle
+	@return false if the queue is full
+*/
+bool OLEDDrawQueue::fillCircle(int16_t x0, int16_t y0, int16_t r, uint8_t color)
+{
+	OLEDDrawOp_t op;
+	OLEDDisplayList one;
+	one.begin(&op, 1);
+	one.fillCircle(x0, y0, r, color);
+	return push(op);
+}
+
+/*!
+	@brief Queues a copy of a string
+	@param x X coordinate of first character
+	@param y Y coordinate
+	@param pText pointer to string of ASCII character's, cut to OLED_QUEUE_TEXT_MAX - 1
+	@param font font to draw with
+	@param size text size, used by fonts 1-6
+	@param color text color
+	@param bg background color, equal to color draws a transparent background
+	@return false if the queue is full or pText is not valid
+	@note '\n' starts a new line at x.
+*/
+bool OLEDDrawQueue::drawText(int16_t x, int16_t y, const char *pText, OLEDFontType_e font,
+	uint8_t size, uint8_t color, uint8_t bg)
+{
+	if (pText == nullptr) return false;
+	OLEDQueueSlot_t *pSlot = reserve();
+	if (pSlot == nullptr) return false;
+	strncpy(pSlot->text, pText, OLED_QUEUE_TEXT_MAX - 1);
+	pSlot->text[OLED_QUEUE_TEXT_MAX - 1] = '\0';
+	OLEDDrawOp_t &op = pSlot->op;
+	op.type = OLEDOp_Text;
+	op.color = color;
+	op.bg = bg;
+	op.font = font;
+	op.size = size;
+	op.p[0] = x;
+	op.p[1] = y;
+	op.box = OLEDRect_t{x, y, 0, 0}; // measured by the renderer
+	op.pData = nullptr;
+#if PICO_ON_DEVICE
+	__dmb();
+	pSlot->ready = 1;
+#else
+	pSlot->ready.store(1, std::memory_order_release);
+#endif
+	return true;
+}
+
+/*!
+	@brief Queues a bitmap
+	@param x x start coordinate
+	@param y y start coordinate
+	@param w width of bitmap in pixels
+	@param h height of bitmap in pixels
+	@param pData horizontally addressed bitmap, rows of (w+7)/8 bytes MSB first, must outlive the command
+	@param color color of set bits
+	@param bg color of clear bits, equal to color leaves them untouched
+	@return false if the queue is full or pData is not valid
+*/
+bool OLEDDrawQueue::drawBitmap(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t *pData,
+	uint8_t color, uint8_t bg)
+{
+	OLEDDrawOp_t op;
+	OLEDDisplayList one;
+	one.begin(&op, 1);
+	if (!one.drawBitmap(x, y, w, h, pData, color, bg)) return false;
+	return push(op);
+}
+
+/*!
+	@brief Draws queued commands in order and marks their areas dirty
+	@param gfx graphics object to draw on, used by the renderer only
+	@param maxOps maximum number of commands to draw, 0 for all ready
+	@return number of commands drawn
+	@note Stops at a slot still being filled, its producer finishes it shortly.
+*/
+uint16_t OLEDDrawQueue::drain(SSD1306_graphics &gfx, uint16_t maxOps)
+{
+	if (_pSlots == nullptr) return 0;
+	uint16_t drawn = 0;
+	uint32_t tail = _tail;
+	while (maxOps == 0 || drawn < maxOps)
+	{
+		OLEDQueueSlot_t &slot = _pSlots[tail % _count];
+		if (tail == _head || !slot.ready) break;
+#if PICO_ON_DEVICE
+		__dmb();
+#endif
+		OLEDDrawOp_t &op = slot.op;
+		if (op.type == OLEDOp_Text && op.pData == nullptr)
+		{
+			op.pData = slot.text;
+			uint8_t oldFont = gfx.getFontNum();
+			uint8_t oldSize = gfx.getTextSize();
+			gfx.setFontNum((OLEDFontType_e)op.font);
+			gfx.setTextSize(op.size);
+			OLEDTextMetrics_t metrics = gfx.measureText(slot.text);
+			gfx.setFontNum((OLEDFontType_e)oldFont);
+			gfx.setTextSize(oldSize);
+			op.box.w = metrics.width;
+			op.box.h = metrics.height;
+		}
+		OLEDDisplayList::drawOp(gfx, op);
+		gfx.markDirty(op.box.x, op.box.y, op.box.w, op.box.h);
+
+		slot.ready = 0;
+		tail++;
+#if PICO_ON_DEVICE
+		__dmb();
+		_tail = tail;
+#else
+		_tail.store(tail, std::memory_order_release);
+#endif
+		drawn++;
+	}
+	return drawn;
+}
+
+/*!
+	@brief Gets the number of reserved commands not drawn yet
+	@return command count
+*/
+uint16_t OLEDDrawQueue::pending(void) const
+{
+	return (uint16_t)(_head - _tail);
+}
+
+/*!
+	@brief Gets the number of commands rejected because the queue was full
+	@return command count since begin
+*/
+uint32_t OLEDDrawQueue::dropped(void) const
+{
+	return _dropped;
+}
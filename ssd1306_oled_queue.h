@@ -0,0 +1,83 @@
+/*!
+	@file ssd1306_oled_queue.h
+	@brief OLED driven by SSD1306 controller. header file
+		for the multi producer draw command queue.
+	@details Lets several tasks, cores or interrupt handlers draw on one
+		display. Producers queue display list ops that carry their own
+		font, size, colors and position, so they never touch the text state
+		of the graphics object. A single renderer drains the queue in order
+		and marks the drawn areas dirty.
+*/
+
+#pragma once
+
+#include "ssd1306_oled_displaylist.h"
+#include "hardware/sync.h"
+#if !PICO_ON_DEVICE
+#include <atomic>
+#endif
+
+#ifndef OLED_QUEUE_TEXT_MAX
+#define OLED_QUEUE_TEXT_MAX 24 /**< Characters of queued text including terminator */
+#endif
+
+#if PICO_ON_DEVICE
+typedef volatile uint32_t OLEDQueueIndex_t; /**< Counter, updated under the hardware spinlock */
+#else
+typedef std::atomic<uint32_t> OLEDQueueIndex_t; /**< Counter, updated with compare and swap */
+#endif
+
+/*! @brief Struct to hold one queued command */
+struct OLEDQueueSlot_t
+{
+	OLEDDrawOp_t op;                 /**< Drawing call, text ops point at text */
+	char text[OLED_QUEUE_TEXT_MAX];  /**< Copy of the string of a text op */
+	OLEDQueueIndex_t ready;          /**< Slot filled, set last by the producer */
+};
+
+/*!
+	@brief class for a queue of draw commands, many producers one renderer
+	@details Producers reserve a slot by advancing the head, fill it and
+		then flag it ready, they never wait for the renderer. A full queue
+		rejects the command and counts it.
+	@note The cores of the RP2040 have no compare and swap, on the device
+		the head is advanced under a hardware spinlock held for a few
+		instructions with interrupts off, so interrupt handlers may queue too.
+		Bitmaps are referenced, not copied.
+*/
+class OLEDDrawQueue
+{
+  public:
+	OLEDDrawQueue(){};
+
+	bool begin(OLEDQueueSlot_t *pSlots, uint16_t count);
+
+	bool push(const OLEDDrawOp_t &op);
+	bool drawPixel(int16_t x, int16_t y, uint8_t color);
+	bool drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint8_t color);
+	bool drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color);
+	bool fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color);
+	bool drawCircle(int16_t x0, int16_t y0, int16_t r, uint8_t color);
+	bool fillCircle(int16_t x0, int16_t y0, int16_t r, uint8_t color);
+	bool drawText(int16_t x, int16_t y, const char *pText, OLEDFontType_e font,
+	  uint8_t size, uint8_t color, uint8_t bg);
+	bool drawBitmap(int16_t x, int16_t y, int16_t w, int16_t h, const uint8_t *pData,
+	  uint8_t color, uint8_t bg);
+
+	uint16_t drain(SSD1306_graphics &gfx, uint16_t maxOps = 0);
+	uint16_t pending(void) const;
+	uint32_t dropped(void) const;
+
+  private:
+
+	OLEDQueueSlot_t *reserve(void);
+
+	OLEDQueueSlot_t *_pSlots = nullptr; /**< Slot ring */
+	uint16_t _count = 0;                /**< Number of slots */
+	OLEDQueueIndex_t _head{0};          /**< Next slot to reserve, free running */
+	OLEDQueueIndex_t _tail{0};          /**< Next slot to drain, written by the renderer only */
+	OLEDQueueIndex_t _dropped{0};       /**< Commands rejected because the queue was full */
+#if PICO_ON_DEVICE
+	spin_lock_t *_pLock = nullptr;      /**< Hardware spinlock guarding the head */
+#endif
+};
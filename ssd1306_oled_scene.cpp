@@ -0,0 +1,509 @@
+/*!
+	@file ssd1306_oled_scene.cpp
+	@brief OLED driven by SSD1306 controller. Source file
+		for the retained mode scene graph.
+*/
+
+#include "ssd1306_oled_scene.h"
+
+// Smallest rectangle holding both, an empty rectangle is ignored
+static OLEDRect_t OLEDRectUnion(const OLEDRect_t &a, const OLEDRect_t &b)
+{
+	if (a.w <= 0 || a.h <= 0) return b;
+	if (b.w <= 0 || b.h <= 0) return a;
+	int16_t x0 = (a.x < b.x) ? a.x : b.x;
+	int16_t y0 = (a.y < b.y) ? a.y : b.y;
+	int16_t x1 = (a.x + a.w > b.x + b.w) ? a.x + a.w : b.x + b.w;
+	int16_t y1 = (a.y + a.h > b.y + b.h) ? a.y + a.h : b.y + b.h;
+	return OLEDRect_t{x0, y0, (int16_t)(x1 - x0), (int16_t)(y1 - y0)};
+}
+
+// True if two rectangles overlap or share an edge
+static bool OLEDRectTouch(const OLEDRect_t &a, const OLEDRect_t &b)
+{
+	return a.x <= b.x + b.w && b.x <= a.x + a.w &&
+		a.y <= b.y + b.h && b.y <= a.y + a.h;
+}
+
+/*!
+	@brief Sets the node arena and empties the scene
+	@param pNodes pointer to array of nodes
+	@param maxNodes number of nodes in the array
+	@param background color damaged areas are cleared to before redrawing
+	@return true for success, false if the array is not valid
+*/
+bool OLEDScene::begin(OLEDSceneNode_t *pNodes, uint16_t maxNodes, uint8_t background)
+{
+	if (pNodes == nullptr || maxNodes == 0)
+	{
+		OLED_ERROR(OLED_BufferNullptr, "scene begin 1", "Node array is not valid pointer or has no nodes\r\n");
+		return false;
+	}
+	_pNodes = pNodes;
+	_maxNodes = (maxNodes > 0x7FFF) ? 0x7FFF : maxNodes;
+	_background = background;
+	clear();
+	return true;
+}
+
+/*!
+	@brief Removes all nodes, the whole screen is damaged
+*/
+void OLEDScene::clear(void)
+{
+	_count = 0;
+	invalidateAll();
+}
+
+/*!
+	@brief Gets the number of nodes
+	@return node count
+*/
+uint16_t OLEDScene::size(void) const {return _count;}
+
+/*!
+	@brief Adds a group, children are positioned relative to it
+	@param parent id of parent group or OLED_SCENE_ROOT
+	@param x x origin relative to parent
+	@param y y origin relative to parent
+	@return node id, -1 if the arena is full or parent is not a group
+*/
+int16_t OLEDScene::addGroup(int16_t parent, int16_t x, int16_t y)
+{
+	int16_t id = addNode(parent, x, y, 0, 0, 0);
+	if (id >= 0) _pNodes[id].group = true;
+	return id;
+}
+
+/*!
+	@brief Adds a rectangle
+	@param parent id of parent group or OLED_SCENE_ROOT
+	@param x x start coordinate relative to parent
+	@param y y start coordinate relative to parent
+	@param w width of the rectangle
+	@param h height of the rectangle
+	@param color color of rectangle
+	@param fill true filled, false outline
+	@return node id, -1 if the arena is full or parent is not a group
+*/
+int16_t OLEDScene::addRect(int16_t parent, int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color, bool fill)
+{
+	int16_t id = addNode(parent, x, y, w, h, color);
+	if (id < 0) return id;
+	OLEDDrawOp_t &op = _pNodes[id].op;
+	op.type = fill ? OLEDOp_FillRect : OLEDOp_Rect;
+	op.p[2] = w;
+	op.p[3] = h;
+	damageNode(id);
+	return id;
+}
+
+/*!
+	@brief Adds a string in the current font and text size
+	@param parent id of parent group or OLED_SCENE_ROOT
+	@param x X coordinate of first character relative to parent
+	@param y Y coordinate relative to parent
+	@param pText pointer to string of ASCII character's, must outlive the scene
+	@param color text color
+	@param bg background color, equal to color draws a transparent background
+	@return node id, -1 if the arena is full, parent is not a group or pText is not valid
+*/
+int16_t OLEDScene::addText(int16_t parent, int16_t x, int16_t y, const char *pText, uint8_t color, uint8_t bg)
+{
+	if (pText == nullptr)
+	{
+		OLED_ERROR(OLED_CharArrayNullptr, "scene addText 1", "String array is not valid pointer: %u \n", OLED_CharArrayNullptr);
+		return -1;
+	}
+	OLEDTextMetrics_t metrics = _gfx.measureText(pText);
+	int16_t id = addNode(parent, x, y, metrics.width, metrics.height, color);
+	if (id < 0) return id;
+	OLEDDrawOp_t &op = _pNodes[id].op;
+	op.type = OLEDOp_Text;
+	op.bg = bg;
+	op.font = _gfx.getFontNum();
+	op.size = _gfx.getTextSize();
+	op.pData = pText;
+	damageNode(id);
+	return id;
+}
+
+/*!
+	@brief Adds a bitmap
+	@param parent id of parent group or OLED_SCENE_ROOT
+	@param x x start coordinate relative to parent
+	@param y y start coordinate relative to parent
+	@param w width of bitmap in pixels
+	@param h height of bitmap in pixels
+	@param pData horizontally addressed bitmap, rows of (w+7)/8 bytes MSB first, must outlive the scene
+	@param color color of set bits
+	@param bg color of clear bits, equal to color leaves them untouched
+	@return node id, -1 if the arena is full, parent is not a group or pData is not valid
+*/
+int16_t OLEDScene::addBitmap(int16_t parent, int16_t x, int16_t y, int16_t w, int16_t h,
+	const uint8_t *pData, uint8_t color, uint8_t bg)
+{
+	if (pData == nullptr)
+	{
+		OLED_ERROR(OLED_BitmapNullptr, "scene addBitmap 1", "Bitmap is is not valid pointer\r\n");
+		return -1;
+	}
+	int16_t id = addNode(parent, x, y, w, h, color);
+	if (id < 0) return id;
+	OLEDDrawOp_t &op = _pNodes[id].op;
+	op.type = OLEDOp_Bitmap;
+	op.bg = bg;
+	op.p[2] = w;
+	op.p[3] = h;
+	op.pData = pData;
+	damageNode(id);
+	return id;
+}
+
+/*!
+	@brief Moves a node, a group moves its children with it
+	@param id node id
+	@param x x coordinate relative to parent
+	@param y y coordinate relative to parent
+	@return false if id is not valid
+*/
+bool OLEDScene::setPosition(int16_t id, int16_t x, int16_t y)
+{
+	if (!validNode(id, true)) return false;
+	OLEDDrawOp_t &op = _pNodes[id].op;
+	if (op.p[0] == x && op.p[1] == y) return true;
+	damageNode(id);
+	op.box.x += x - op.p[0];
+	op.box.y += y - op.p[1];
+	op.p[0] = x;
+	op.p[1] = y;
+	damageNode(id);
+	return true;
+}
+
+/*!
+	@brief Resizes a rectangle or bitmap node
+	@param id node id
+	@param w new width
+	@param h new height
+	@return false if id is not a rectangle or bitmap
+	@note A bitmap must hold data for the new size.
+*/
+bool OLEDScene::setSize(int16_t id, int16_t w, int16_t h)
+{
+	if (!validNode(id, false)) return false;
+	OLEDDrawOp_t &op = _pNodes[id].op;
+	if (op.type == OLEDOp_Text)
+	{
+		OLED_ERROR(OLED_SceneNodeInvalid, "scene setSize 1", "Text node is sized by its string: %d\r\n", id);
+		return false;
+	}
+	if (op.p[2] == w && op.p[3] == h) return true;
+	damageNode(id);
+	op.p[2] = op.box.w = w;
+	op.p[3] = op.box.h = h;
+	damageNode(id);
+	return true;
+}
+
+/*!
+	@brief Changes the colors of a node
+	@param id node id
+	@param color foreground color
+	@param bg background color of text and bitmaps, ignored by rectangles
+	@return false if id is not valid or a group
+*/
+bool OLEDScene::setColor(int16_t id, uint8_t color, uint8_t bg)
+{
+	if (!validNode(id, false)) return false;
+	OLEDDrawOp_t &op = _pNodes[id].op;
+	if (op.type == OLEDOp_Rect || op.type == OLEDOp_FillRect) bg = color;
+	if (op.color == color && op.bg == bg) return true;
+	op.color = color;
+	op.bg = bg;
+	damageNode(id);
+	return true;
+}
+
+/*!
+	@brief Changes the string of a text node
+	@param id node id
+	@param pText pointer to string of ASCII character's, may be the same pointer
+		with new contents
+	@return false if id is not a text node or pText is not valid
+	@note The text is measured again with the font the node was added with.
+*/
+bool OLEDScene::setText(int16_t id, const char *pText)
+{
+	if (!validNode(id, false)) return false;
+	OLEDDrawOp_t &op = _pNodes[id].op;
+	if (op.type != OLEDOp_Text || pText == nullptr)
+	{
+		OLED_ERROR(OLED_SceneNodeInvalid, "scene setText 1", "Node is not text or string not valid: %d\r\n", id);
+		return false;
+	}
+	damageNode(id);
+
+	uint8_t oldFont = _gfx.getFontNum();
+	uint8_t oldSize = _gfx.getTextSize();
+	if (oldFont != op.font) _gfx.setFontNum((OLEDFontType_e)op.font);
+	if (oldSize != op.size) _gfx.setTextSize(op.size);
+	OLEDTextMetrics_t metrics = _gfx.measureText(pText);
+	if (oldFont != op.font) _gfx.setFontNum((OLEDFontType_e)oldFont);
+	if (oldSize != op.size) _gfx.setTextSize(oldSize);
+
+	op.pData = pText;
+	op.box.w = metrics.width;
+	op.box.h = metrics.height;
+	damageNode(id);
+	return true;
+}
+
+/*!
+	@brief Shows or hides a node, a group hides its children with it
+	@param id node id
+	@param visible true drawn
+	@return false if id is not valid
+*/
+bool OLEDScene::setVisible(int16_t id, bool visible)
+{
+	if (!validNode(id, true)) return false;
+	if (_pNodes[id].visible == visible) return true;
+	damageNode(id);
+	_pNodes[id].visible = visible;
+	damageNode(id);
+	return true;
+}
+
+/*!
+	@brief Marks the area of a node for redrawing
+	@param id node id
+	@return false if id is not valid
+*/
+bool OLEDScene::invalidate(int16_t id)
+{
+	if (!validNode(id, true)) return false;
+	damageNode(id);
+	return true;
+}
+
+/*!
+	@brief Marks the whole screen for redrawing
+*/
+void OLEDScene::invalidateAll(void)
+{
+	_damage[0] = OLEDRect_t{0, 0, _gfx.width(), _gfx.height()};
+	_damageCount = 1;
+}
+
+/*!
+	@brief Checks if anything needs redrawing
+	@return true if render would draw
+*/
+bool OLEDScene::isDamaged(void) const {return _damageCount > 0;}
+
+/*!
+	@brief Redraws the damaged areas and marks them dirty
+	@return number of areas redrawn
+	@details Each area is cleared to the background and every visible node
+		overlapping it is drawn in creation order, clipped to the area.
+		Call OLEDupdateDirty afterwards to send the areas to the display.
+*/
+uint8_t OLEDScene::render(void)
+{
+	OLEDRect_t saved = _gfx.getClipRect();
+	uint8_t areas = _damageCount;
+	for (uint8_t d = 0; d < _damageCount; d++)
+	{
+		const OLEDRect_t &area = _damage[d];
+		_gfx.setClipRect(area.x, area.y, area.w, area.h);
+		_gfx.fillRect(area.x, area.y, area.w, area.h, _background);
+		for (int16_t id = 0; id < (int16_t)_count; id++)
+		{
+			if (_pNodes[id].group) continue;
+			int16_t dx, dy;
+			if (!nodeOffset(id, dx, dy)) continue;
+			OLEDDrawOp_t op = _pNodes[id].op;
+			op.box.x += dx;
+			op.box.y += dy;
+			if (!OLEDRectTouch(op.box, area) || op.box.w <= 0 || op.box.h <= 0) continue;
+			op.p[0] += dx;
+			op.p[1] += dy;
+			OLEDDisplayList::drawOp(_gfx, op);
+		}
+		_gfx.markDirty(area.x, area.y, area.w, area.h);
+	}
+	_gfx.setClipRect(saved.x, saved.y, saved.w, saved.h);
+	_damageCount = 0;
+	return areas;
+}
+
+/*!
+	@brief Checks a node id , used internally
+	@param id node id
+	@param groupAllowed true a group is a valid node
+	@return true if valid
+*/
+bool OLEDScene::validNode(int16_t id, bool groupAllowed) const
+{
+	if (id < 0 || id >= (int16_t)_count || (!groupAllowed && _pNodes[id].group))
+	{
+		OLED_ERROR(OLED_SceneNodeInvalid, "scene node 1", "Node id not valid: %d\r\n", id);
+		return false;
+	}
+	return true;
+}
+
+/*!
+	@brief Appends a node , used internally
+	@param parent id of parent group or OLED_SCENE_ROOT
+	@param x x coordinate relative to parent
+	@param y y coordinate relative to parent
+	@param w width of bounding box
+	@param h height of bounding box
+	@param color foreground color
+	@return node id, -1 on failure
+*/
+int16_t OLEDScene::addNode(int16_t parent, int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color)
+{
+	if (parent != OLED_SCENE_ROOT && (parent < 0 || parent >= (int16_t)_count || !_pNodes[parent].group))
+	{
+		OLED_ERROR(OLED_SceneNodeInvalid, "scene add 1", "Parent is not a group: %d\r\n", parent);
+		return -1;
+	}
+	if (_count >= _maxNodes)
+	{
+		OLED_ERROR(OLED_SceneFull, "scene add 2", "Node arena full, %u nodes\r\n", _maxNodes);
+		return -1;
+	}
+	int16_t id = _count++;
+	OLEDSceneNode_t &node = _pNodes[id];
+	node.parent = parent;
+	node.group = false;
+	node.visible = true;
+	node.op.type = OLEDOp_FillRect;
+	node.op.color = color;
+	node.op.bg = color;
+	node.op.font = 0;
+	node.op.size = 1;
+	node.op.p[0] = x;
+	node.op.p[1] = y;
+	node.op.box = OLEDRect_t{x, y, w, h};
+	node.op.pData = nullptr;
+	return id;
+}
+
+/*!
+	@brief Sums the origins of the groups a node is in , used internally
+	@param id node id
+	@param dx x offset to screen coordinates
+	@param dy y offset to screen coordinates
+	@return false if the node or one of its groups is hidden
+*/
+bool OLEDScene::nodeOffset(int16_t id, int16_t &dx, int16_t &dy) const
+{
+	dx = 0;
+	dy = 0;
+	if (!_pNodes[id].visible) return false;
+	for (int16_t g = _pNodes[id].parent; g != OLED_SCENE_ROOT; g = _pNodes[g].parent)
+	{
+		if (!_pNodes[g].visible) return false;
+		dx += _pNodes[g].op.p[0];
+		dy += _pNodes[g].op.p[1];
+	}
+	return true;
+}
+
+/*!
+	@brief Checks if a node is a descendant of a group , used internally
+	@param id node id
+	@param group group id
+	@return true if id is in group at any depth
+*/
+bool OLEDScene::inGroup(int16_t id, int16_t group) const
+{
+	for (int16_t g = _pNodes[id].parent; g != OLED_SCENE_ROOT; g = _pNodes[g].parent)
+		if (g == group) return true;
+	return false;
+}
+
+/*!
+	@brief Gets the screen area a node covers , used internally
+	@param id node id
+	@return bounding rectangle, empty if hidden, a group covers its children
+*/
+OLEDRect_t OLEDScene::nodeBounds(int16_t id) const
+{
+	OLEDRect_t bounds{0, 0, 0, 0};
+	if (_pNodes[id].group)
+	{
+		for (int16_t child = id + 1; child < (int16_t)_count; child++)
+			if (!_pNodes[child].group && inGroup(child, id))
+				bounds = OLEDRectUnion(bounds, nodeBounds(child));
+		return bounds;
+	}
+	int16_t dx, dy;
+	if (!nodeOffset(id, dx, dy)) return bounds;
+	bounds = _pNodes[id].op.box;
+	bounds.x += dx;
+	bounds.y += dy;
+	return bounds;
+}
+
+/*!
+	@brief Adds the current area of a node to the damage , used internally
+	@param id node id
+*/
+void OLEDScene::damageNode(int16_t id)
+{
+	addDamage(nodeBounds(id));
+}
+
+/*!
+	@brief Adds an area to the damage , used internally
+	@param rect area in screen coordinates
+	@details Areas that touch are merged. When all slots are used the area is
+		merged with the one that grows least.
+*/
+void OLEDScene::addDamage(OLEDRect_t rect)
+{
+	// trim to the screen
+	if (rect.x < 0) { rect.w += rect.x; rect.x = 0; }
+	if (rect.y < 0) { rect.h += rect.y; rect.y = 0; }
+	if (rect.x + rect.w > _gfx.width()) rect.w = _gfx.width() - rect.x;
+	if (rect.y + rect.h > _gfx.height()) rect.h = _gfx.height() - rect.y;
+	if (rect.w <= 0 || rect.h <= 0) return;
+
+	uint8_t d = 0;
+	while (d < _damageCount)
+	{
+		if (OLEDRectTouch(rect, _damage[d]))
+		{
+			rect = OLEDRectUnion(rect, _damage[d]);
+			_damage[d] = _damage[--_damageCount];
+			d = 0; // the larger area may now touch an earlier one
+		}
+		else
+			d++;
+	}
+	if (_damageCount == OLED_SCENE_MAX_DAMAGE)
+	{
+		uint8_t best = 0;
+		int32_t bestGrowth = INT32_MAX;
+		for (d = 0; d < _damageCount; d++)
+		{
+			OLEDRect_t merged = OLEDRectUnion(rect, _damage[d]);
+			int32_t growth = (int32_t)merged.w * merged.h - (int32_t)_damage[d].w * _damage[d].h;
+			if (growth < bestGrowth)
+			{
+				bestGrowth = growth;
+				best = d;
+			}
+		}
+		rect = OLEDRectUnion(rect, _damage[best]);
+		_damage[best] = _damage[--_damageCount];
+		addDamage(rect);
+		return;
+	}
+	_damage[_damageCount++] = rect;
+}
@@ -0,0 +1,81 @@
+/*!
+	@file ssd1306_oled_scene.h
+	@brief OLED driven by SSD1306 controller. header file
+		for the retained mode scene graph.
+	@details Rectangles, text, bitmaps and groups are kept as nodes in a user
+		supplied arena. Changing a node records its old and new bounds as
+		damage. render() redraws only the damaged areas, all nodes overlapping
+		them in creation order, and marks them dirty so OLEDupdateDirty sends
+		just those windows.
+*/
+
+#pragma once
+
+#include "ssd1306_oled_displaylist.h"
+
+#ifndef OLED_SCENE_MAX_DAMAGE
+#define OLED_SCENE_MAX_DAMAGE 4 /**< Damage rectangles kept before they are merged */
+#endif
+
+#define OLED_SCENE_ROOT -1 /**< Parent id of nodes not in a group */
+
+/*! @brief Struct to hold one scene node */
+struct OLEDSceneNode_t
+{
+	OLEDDrawOp_t op;   /**< Drawing call, coordinates and box relative to the parent group */
+	int16_t parent;    /**< Id of parent group, OLED_SCENE_ROOT for none */
+	bool group;        /**< Node is a group, op.p[0] op.p[1] hold its origin */
+	bool visible;      /**< Node and for a group its children are drawn */
+};
+
+/*!
+	@brief class for a retained mode scene graph with damage tracking
+	@details Nodes are drawn in the order they were added, later nodes on top.
+		A group moves and hides its children together.
+	@note Strings and bitmaps are referenced, not copied. After changing the
+		contents of a string call setText again so its area is redrawn.
+*/
+class OLEDScene
+{
+  public:
+	OLEDScene(SSD1306_graphics &gfx) : _gfx(gfx) {};
+
+	bool begin(OLEDSceneNode_t *pNodes, uint16_t maxNodes, uint8_t background = 0);
+	void clear(void);
+	uint16_t size(void) const;
+
+	int16_t addGroup(int16_t parent, int16_t x, int16_t y);
+	int16_t addRect(int16_t parent, int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color, bool fill);
+	int16_t addText(int16_t parent, int16_t x, int16_t y, const char *pText, uint8_t color, uint8_t bg);
+	int16_t addBitmap(int16_t parent, int16_t x, int16_t y, int16_t w, int16_t h,
+	  const uint8_t *pData, uint8_t color, uint8_t bg);
+
+	bool setPosition(int16_t id, int16_t x, int16_t y);
+	bool setSize(int16_t id, int16_t w, int16_t h);
+	bool setColor(int16_t id, uint8_t color, uint8_t bg);
+	bool setText(int16_t id, const char *pText);
+	bool setVisible(int16_t id, bool visible);
+	bool invalidate(int16_t id);
+	void invalidateAll(void);
+
+	bool isDamaged(void) const;
+	uint8_t render(void);
+
+  private:
+
+	bool validNode(int16_t id, bool groupAllowed) const;
+	int16_t addNode(int16_t parent, int16_t x, int16_t y, int16_t w, int16_t h, uint8_t color);
+	bool nodeOffset(int16_t id, int16_t &dx, int16_t &dy) const;
+	bool inGroup(int16_t id, int16_t group) const;
+	OLEDRect_t nodeBounds(int16_t id) const;
+	void damageNode(int16_t id);
+	void addDamage(OLEDRect_t rect);
+
+	SSD1306_graphics &_gfx;                       /**< Graphics object the scene draws on */
+	OLEDSceneNode_t *_pNodes = nullptr;           /**< Node arena */
+	uint16_t _maxNodes = 0;                       /**< Number of nodes in arena */
+	uint16_t _count = 0;                          /**< Number of nodes added */
+	uint8_t _background = 0;                      /**< Color damaged areas are cleared to */
+	OLEDRect_t _damage[OLED_SCENE_MAX_DAMAGE];    /**< Areas to redraw */
+	uint8_t _damageCount = 0;                     /**< Number of damage rectangles */
+};
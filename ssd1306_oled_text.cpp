@@ -0,0 +1,358 @@
+/*!
+	@file ssd1306_oled_text.cpp
+	@brief OLED driven by SSD1306 controller. Source file
+		for the text layout and text field functions.
+*/
+
+#include "ssd1306_oled_text.h"
+
+/*!
+	@brief Lays out a string in a bounding box using the current font and text size
+	@param gfx graphics object supplying the font metrics
+	@param pText pointer to string of ASCII character's, must outlive the layout
+	@param x X coordinate of box
+	@param y Y coordinate of box
+	@param w width of box
+	@param h height of box
+	@param align horizontal alignment of each line
+	@param wordWrap true break lines at spaces, false clip each line at the box edge
+	@param ellipsis true replace the end of truncated text with "..."
+	@return OLED_Return_Codes_e enum
+	@note Words longer than the box are broken mid-word.
+		'\n' starts a new line. Lines that do not fit the box height are dropped.
+*/
+OLED_Return_Codes_e OLEDTextLayout::layout(SSD1306_graphics &gfx, const char *pText,
+	int16_t x, int16_t y, int16_t w, int16_t h,
+	OLEDTextAlign_e align, bool wordWrap, bool ellipsis)
+{
+	invalidate();
+	if (pText == nullptr)
+	{
+		OLED_ERROR(OLED_CharArrayNullptr, "layout 1", "String array is not valid pointer: %u \n", OLED_CharArrayNullptr);
+		return OLED_CharArrayNullptr;
+	}
+
+	_pText = pText;
+	_x = x;
+	_y = y;
+	_w = w;
+	_align = align;
+	_ellipsis = ellipsis;
+	_fontNumber = gfx.getFontNum();
+	_textSize = gfx.getTextSize();
+	_advance = gfx.getCharAdvance();
+	_lineHeight = gfx.getLineHeight();
+
+	int16_t fitChars = (w > 0) ? (w / _advance) : 0;
+	int16_t fitLines = (h > 0) ? (h / _lineHeight) : 0;
+	uint8_t maxChars = (fitChars > 255) ? 255 : fitChars;
+	uint8_t maxLines = (fitLines > OLED_LAYOUT_MAX_LINES) ? OLED_LAYOUT_MAX_LINES : fitLines;
+
+	uint16_t length = strlen(pText);
+	uint16_t pos = 0;
+
+	while (pos < length)
+	{
+		if (_lineCount == maxLines || maxChars == 0)
+		{
+			_truncated = true;
+			break;
+		}
+		uint16_t paraEnd = pos;
+		while (paraEnd < length && pText[paraEnd] != '\n') paraEnd++;
+
+		if (paraEnd - pos <= maxChars)
+		{
+			addLine(pos, paraEnd - pos, maxChars);
+			pos = paraEnd + 1;
+			continue;
+		}
+		if (!wordWrap)
+		{
+			addLine(pos, maxChars, maxChars);
+			_truncated = true;
+			if (_ellipsis) applyEllipsis(maxChars);
+			pos = paraEnd + 1;
+			continue;
+		}
+
+		// Break at the last space that fits , else mid-word
+		uint16_t lineEnd = pos + maxChars;
+		if (pText[lineEnd] != ' ')
+		{
+			uint16_t space = lineEnd - 1;
+			while (space > pos && pText[space] != ' ') space--;
+			if (space > pos) lineEnd = space;
+		}
+		uint16_t end = lineEnd;
+		while (end > pos && pText[end - 1] == ' ') end--;
+		addLine(pos, end - pos, maxChars);
+
+		pos = lineEnd;
+		while (pos < paraEnd && pText[pos] == ' ') pos++;
+		if (pos == paraEnd) pos++;
+	}
+
+	if (_truncated && _ellipsis && _lineCount > 0 && _lines[_lineCount - 1].dots == 0)
+		applyEllipsis(maxChars);
+
+	// the last glyph of a line ends before its blank padding column
+	int16_t pad = (_fontNumber < OLEDFont_Bignum) ? _textSize : 0;
+	for (uint8_t i = 0; i < _lineCount; i++)
+	{
+		uint8_t count = _lines[i].length + _lines[i].dots;
+		int16_t lineWidth = (count > 0) ? (count * _advance) - pad : 0;
+		switch (_align)
+		{
+			case OLEDAlign_Center: _lines[i].xOffset = (w - lineWidth) / 2; break;
+			case OLEDAlign_Right: _lines[i].xOffset = w - lineWidth; break;
+			default: _lines[i].xOffset = 0; break;
+		}
+	}
+	return OLED_Success;
+}
+
+/*!
+	@brief Draws a cached layout, no line breaking is recomputed
+	@param gfx graphics object to draw on
+	@param color text color
+	@param bg background color
+	@return OLED_Return_Codes_e enum , last drawChar failure if any
+	@note The font and text size in use at layout time are selected for the
+		duration of the call and then restored. Characters off the screen
+		are skipped , a box partly off screen is clipped.
+*/
+OLED_Return_Codes_e OLEDTextLayout::render(SSD1306_graphics &gfx, uint8_t color, uint8_t bg) const
+{
+	if (!isValid())
+	{
+		OLED_ERROR(OLED_CharArrayNullptr, "layout 2", "Layout is empty, call layout first: %u \n", OLED_CharArrayNullptr);
+		return OLED_CharArrayNullptr;
+	}
+
+	uint8_t oldFont = gfx.getFontNum();
+	uint8_t oldSize = gfx.getTextSize();
+	if (oldFont != _fontNumber) gfx.setFontNum((OLEDFontType_e)_fontNumber);
+	if (oldSize != _textSize) gfx.setTextSize(_textSize);
+
+	OLED_Return_Codes_e ReturnCode = OLED_Success;
+	for (uint8_t i = 0; i < _lineCount; i++)
+	{
+		int16_t cx = lineX(i);
+		int16_t cy = lineY(i);
+		const char *pLine = _pText + _lines[i].start;
+		for (uint8_t j = 0; j < _lines[i].length + _lines[i].dots; j++, cx += _advance)
+		{
+			if (cx >= gfx.width() || cy >= gfx.height() ||
+				(cx + _advance) <= 0 || (cy + _lineHeight) <= 0)
+				continue; // clipped , off screen
+			uint8_t character = (j < _lines[i].length) ? pLine[j] : '.';
+			OLED_Return_Codes_e DrawCharReturnCode;
+			if (_fontNumber < OLEDFont_Bignum)
+				DrawCharReturnCode = gfx.drawChar(cx, cy, (unsigned char)character, color, bg, _textSize);
+			else
+				DrawCharReturnCode = gfx.drawChar(cx, cy, character, color, bg);
+			if (DrawCharReturnCode != OLED_Success)
+				ReturnCode = DrawCharReturnCode;
+		}
+	}
+
+	if (oldFont != _fontNumber) gfx.setFontNum((OLEDFontType_e)oldFont);
+	if (oldSize != _textSize) gfx.setTextSize(oldSize);
+	return ReturnCode;
+}
+
+/*!
+	@brief Discards the cached layout
+*/
+void OLEDTextLayout::invalidate(void)
+{
+	_pText = nullptr;
+	_lineCount = 0;
+	_fontNumber = 0;
+	_truncated = false;
+}
+
+/*!
+	@brief Checks if the layout holds a result that can be rendered
+	@return true if layout() succeeded since the last invalidate()
+*/
+bool OLEDTextLayout::isValid(void) const {return _pText != nullptr;}
+
+/*!
+	@brief Checks if the text was cut short to fit the box
+	@return true if lines or characters were dropped
+*/
+bool OLEDTextLayout::isTruncated(void) const {return _truncated;}
+
+/*!
+	@brief Gets the number of laid out lines
+	@return line count 0 - OLED_LAYOUT_MAX_LINES
+*/
+uint8_t OLEDTextLayout::lineCount(void) const {return _lineCount;}
+
+/*!
+	@brief Gets the screen x position of a line
+	@param line line index
+	@return X coordinate after alignment
+*/
+int16_t OLEDTextLayout::lineX(uint8_t line) const {return _x + _lines[line].xOffset;}
+
+/*!
+	@brief Gets the screen y position of a line
+	@param line line index
+	@return Y coordinate
+*/
+int16_t OLEDTextLayout::lineY(uint8_t line) const {return _y + line * _lineHeight;}
+
+/*!
+	@brief Gets the number of glyphs drawn on a line
+	@param line line index
+	@return characters plus ellipsis dots
+*/
+uint8_t OLEDTextLayout::lineLength(uint8_t line) const {return _lines[line].length + _lines[line].dots;}
+
+/*!
+	@brief Appends a line to the layout , used internally
+	@param start offset of first character in the string
+	@param length number of characters
+	@param maxChars characters that fit the box width
+*/
+void OLEDTextLayout::addLine(uint16_t start, uint16_t length, uint8_t maxChars)
+{
+	_lines[_lineCount].start = start;
+	_lines[_lineCount].length = (length > maxChars) ? maxChars : length;
+	_lines[_lineCount].dots = 0;
+	_lines[_lineCount].xOffset = 0;
+	_lineCount++;
+}
+
+/*!
+	@brief Shortens the last line so "..." fits behind it , used internally
+	@param maxChars characters that fit the box width
+*/
+void OLEDTextLayout::applyEllipsis(uint8_t maxChars)
+{
+	OLEDTextLine_t &line = _lines[_lineCount - 1];
+	line.dots = (maxChars < 3) ? maxChars : 3;
+	if (line.length + line.dots > maxChars)
+		line.length = maxChars - line.dots;
+	while (line.length > 0 && _pText[line.start + line.length - 1] == ' ')
+		line.length--;
+}
+
+/*!
+	@brief init a text field
+	@param x X coordinate of first character
+	@param y Y coordinate
+	@param maxChars number of character cells, max OLED_TEXTFIELD_MAX_CHARS
+*/
+OLEDTextField::OLEDTextField(int16_t x, int16_t y, uint8_t maxChars) :
+	_x(x), _y(y)
+{
+	_maxChars = (maxChars > OLED_TEXTFIELD_MAX_CHARS) ? OLED_TEXTFIELD_MAX_CHARS : maxChars;
+	invalidate();
+}
+
+/*!
+	@brief Draws a new value, redrawing only the cells that changed
+	@param gfx graphics object to draw on, its current font and text size are used
+	@param pText pointer to string of ASCII character's, longer than the field is cut
+	@param color text color
+	@param bg background color
+	@return OLED_Return_Codes_e enum , last drawChar failure if any
+	@note A change of font, size, colors or position redraws every cell.
+		Cells past the end of the string are cleared to the background.
+*/
+OLED_Return_Codes_e OLEDTextField::update(SSD1306_graphics &gfx, const char *pText, uint8_t color, uint8_t bg)
+{
+	if (pText == nullptr)
+	{
+		OLED_ERROR(OLED_CharArrayNullptr, "textfield 1", "String array is not valid pointer: %u \n", OLED_CharArrayNullptr);
+		return OLED_CharArrayNullptr;
+	}
+	if (gfx.getFontNum() != _fontNumber || gfx.getTextSize() != _textSize ||
+		color != _color || bg != _bg)
+	{
+		invalidate();
+		_fontNumber = gfx.getFontNum();
+		_textSize = gfx.getTextSize();
+		_color = color;
+		_bg = bg;
+	}
+
+	const bool smallFont = _fontNumber < OLEDFont_Bignum;
+	const int16_t advance = gfx.getCharAdvance();
+	const int16_t lineHeight = gfx.getLineHeight();
+	OLED_Return_Codes_e ReturnCode = OLED_Success;
+	int16_t runStart = -1;
+	bool ended = false;
+	_changed = 0;
+
+	for (uint8_t i = 0; i <= _maxChars; i++)
+	{
+		bool changed = false;
+		if (i < _maxChars)
+		{
+			char character = ' ';
+			if (!ended && pText[i] != '\0') character = pText[i];
+			else ended = true;
+			changed = (character != _last[i]);
+			if (changed)
+			{
+				int16_t cx = _x + (i * advance);
+				OLED_Return_Codes_e DrawCharReturnCode = OLED_CharFontASCIIRange;
+				if (character != ' ' || gfx.getGlyph(' ') != nullptr)
+				{
+					if (smallFont)
+						DrawCharReturnCode = gfx.drawChar(cx, _y, (unsigned char)character, color, bg, _textSize);
+					else
+						DrawCharReturnCode = gfx.drawChar(cx, _y, (uint8_t)character, color, bg);
+				}
+				if (DrawCharReturnCode != OLED_Success)
+				{
+					gfx.fillRect(cx, _y, advance, lineHeight, bg);
+					if (character != ' ') ReturnCode = DrawCharReturnCode;
+				}
+				_last[i] = character;
+				_changed++;
+			}
+		}
+		// mark each run of changed cells as one area
+		if (changed && runStart < 0) runStart = i;
+		if (!changed && runStart >= 0)
+		{
+			gfx.markDirty(_x + (runStart * advance), _y, (i - runStart) * advance, lineHeight);
+			runStart = -1;
+		}
+	}
+	return ReturnCode;
+}
+
+/*!
+	@brief Forgets what was drawn, the next update redraws every cell
+*/
+void OLEDTextField::invalidate(void)
+{
+	memset(_last, 0, sizeof(_last));
+	_fontNumber = 0;
+}
+
+/*!
+	@brief Moves the field, the next update redraws every cell
+	@param x X coordinate of first character
+	@param y Y coordinate
+	@note The old area is not cleared.
+*/
+void OLEDTextField::setPosition(int16_t x, int16_t y)
+{
+	_x = x;
+	_y = y;
+	invalidate();
+}
+
+/*!
+	@brief Gets the number of cells redrawn by the last update
+	@return cell count 0 - maxChars
+*/
+uint8_t OLEDTextField::changedCells(void) const {return _changed;}
@@ -0,0 +1,111 @@
+/*!
+	@file ssd1306_oled_text.h
+	@brief OLED driven by SSD1306 controller. header file
+		for the text layout and text field functions.
+	@details Lays text out into a bounding box once ( line breaks, alignment,
+		clipping and ellipsis ) and caches the result so it can be
+		rendered again without recomputation. Text fields that redraw
+		only the characters that changed.
+*/
+
+#pragma once
+
+#include "ssd1306_oled_graphics.h"
+
+#ifndef OLED_LAYOUT_MAX_LINES
+#define OLED_LAYOUT_MAX_LINES 8 /**< Maximum number of lines held by one OLEDTextLayout */
+#endif
+
+#ifndef OLED_TEXTFIELD_MAX_CHARS
+#define OLED_TEXTFIELD_MAX_CHARS 16 /**< Maximum number of characters in one OLEDTextField */
+#endif
+
+/*! Enum to define horizontal alignment of a text layout */
+enum OLEDTextAlign_e : uint8_t
+{
+	OLEDAlign_Left = 0,   /**< Lines start at the left edge of the box */
+	OLEDAlign_Center = 1, /**< Lines are centered in the box */
+	OLEDAlign_Right = 2   /**< Lines end at the right edge of the box */
+};
+
+/*!
+	@brief class to lay out text in a bounding box and cache the result
+	@note The text is not copied, the string must outlive the layout.
+*/
+class OLEDTextLayout
+{
+  public:
+	OLEDTextLayout(){};
+
+	OLED_Return_Codes_e layout(SSD1306_graphics &gfx, const char *pText,
+		int16_t x, int16_t y, int16_t w, int16_t h,
+		OLEDTextAlign_e align = OLEDAlign_Left, bool wordWrap = true, bool ellipsis = true);
+	OLED_Return_Codes_e render(SSD1306_graphics &gfx, uint8_t color, uint8_t bg) const;
+	void invalidate(void);
+
+	bool isValid(void) const;
+	bool isTruncated(void) const;
+	uint8_t lineCount(void) const;
+	int16_t lineX(uint8_t line) const;
+	int16_t lineY(uint8_t line) const;
+	uint8_t lineLength(uint8_t line) const;
+
+  private:
+
+	/*! @brief one laid out line, a run of the source string plus ellipsis dots */
+	struct OLEDTextLine_t
+	{
+		uint16_t start;    /**< Offset of first character in source string */
+		uint8_t length;    /**< Number of source characters on the line */
+		uint8_t dots;      /**< Number of ellipsis dots appended to the line */
+		int16_t xOffset;   /**< Offset of line from box x due to alignment */
+	};
+
+	void addLine(uint16_t start, uint16_t length, uint8_t maxChars);
+	void applyEllipsis(uint8_t maxChars);
+
+	const char *_pText = nullptr; /**< Source string */
+	OLEDTextLine_t _lines[OLED_LAYOUT_MAX_LINES]; /**< Laid out lines */
+	uint8_t _lineCount = 0;   /**< Number of laid out lines */
+	int16_t _x = 0;           /**< Box x position */
+	int16_t _y = 0;           /**< Box y position */
+	int16_t _w = 0;           /**< Box width */
+	int16_t _advance = 0;     /**< Character advance at layout time */
+	int16_t _lineHeight = 0;  /**< Line height at layout time */
+	uint8_t _fontNumber = 0;  /**< Font at layout time , 0 = not laid out */
+	uint8_t _textSize = 1;    /**< Text size at layout time */
+	OLEDTextAlign_e _align = OLEDAlign_Left; /**< Horizontal alignment */
+	bool _truncated = false;  /**< Text did not fit the box */
+	bool _ellipsis = false;   /**< Mark truncation with dots */
+};
+
+/*!
+	@brief class for a fixed position single line text field
+	@details Remembers the string, font, size and colors it last drew. An update
+		redraws only the character cells that differ, background included,
+		and marks just those cells dirty for OLEDupdateDirty.
+	@note The background color must differ from the text color so a
+		redrawn cell covers the old glyph.
+*/
+class OLEDTextField
+{
+  public:
+	OLEDTextField(int16_t x, int16_t y, uint8_t maxChars);
+
+	OLED_Return_Codes_e update(SSD1306_graphics &gfx, const char *pText, uint8_t color, uint8_t bg);
+	void invalidate(void);
+	void setPosition(int16_t x, int16_t y);
+	uint8_t changedCells(void) const;
+
+  private:
+
+	char _last[OLED_TEXTFIELD_MAX_CHARS]; /**< Characters last drawn, blank cells hold ' ' */
+	int16_t _x;               /**< X coordinate of first cell */
+	int16_t _y;               /**< Y coordinate of cells */
+	uint8_t _maxChars;        /**< Number of cells */
+	uint8_t _fontNumber = 0;  /**< Font last drawn with , 0 = never drawn */
+	uint8_t _textSize = 1;    /**< Text size last drawn with */
+	uint8_t _color = 0;       /**< Text color last drawn with */
+	uint8_t _bg = 0;          /**< Background color last drawn with */
+	uint8_t _changed = 0;     /**< Cells redrawn by the last update */
+};
@@ -0,0 +1,195 @@
+/*!
+	@file ssd1306_oled_ticker.cpp
+	@brief OLED driven by SSD1306 controller. Source file
+		for the hardware scrolled text ticker.
+*/
+
+#include "ssd1306_oled_ticker.h"
+
+/*!
+	@brief Draws the text into a page and starts the hardware scroll
+	@param page display RAM page 0-7
+	@param pText pointer to string of ASCII character's, must outlive the ticker
+	@param interval frames per column step
+	@return false if the font is not 1-6 or pText is not valid
+	@note The font selected on the display is used. The frame period is
+		estimated for the panel height, see setFramePeriod.
+*/
+bool OLEDTicker::begin(uint8_t page, const char *pText, OLEDScrollInterval_e interval)
+{
+	if (_oled.getFontNum() >= OLEDFont_Bignum)
+	{
+		OLED_ERROR(OLED_WrongFont, "ticker begin 1", "Wrong font selected, must be font 1-6: %u\r\n", OLED_WrongFont);
+		return false;
+	}
+	if (pText == nullptr || pText[0] == '\0')
+	{
+		OLED_ERROR(OLED_CharArrayNullptr, "ticker begin 2", "String array is not valid pointer or empty: %u \n", OLED_CharArrayNullptr);
+		return false;
+	}
+	end();
+	_glyphWidth = (_oled.getCharAdvance() / _oled.getTextSize()) - 1;
+	// fonts 1-6 are one flat table, find its first character and length once
+	_pFont = nullptr;
+	_fontCount = 0;
+	for (uint16_t c = 0; c < 256; c++)
+	{
+		const uint8_t *pGlyph = _oled.getGlyph((uint8_t)c);
+		if (pGlyph == nullptr)
+		{
+			if (_pFont != nullptr) break;
+			continue;
+		}
+		if (_pFont == nullptr)
+		{
+			_pFont = pGlyph;
+			_fontFirst = (uint8_t)c;
+		}
+		_fontCount++;
+	}
+	_width = _oled.width();
+	_pText = pText;
+	_textColumns = (strlen(pText) + 1) * (_glyphWidth + 1);
+	_page = page & (SSD1306_GDDRAM_PAGES - 1);
+	_interval = interval;
+	if (_framePeriodUs == 0)
+		setFramePeriod((uint32_t)(((uint64_t)OLED_TICKER_DCLKS_PER_ROW * _oled.height() * 1000000) / OLED_TICKER_FOSC_HZ));
+	else
+		setFramePeriod(_framePeriodUs);
+	_base = 0;
+	restart();
+	return true;
+}
+
+/*!
+	@brief Stops the scroll and leaves the current text position on the display
+*/
+void OLEDTicker::end(void)
+{
+	if (!_running) return;
+	_base = offset();
+	_oled.OLEDStopScroll();
+	_running = false;
+	// display RAM is not reliable after a scroll stop, rewrite the page
+	_oled.OLEDSetWindow(0, _width - 1, _page, _page);
+	writeColumns(_base, _width);
+}
+
+/*!
+	@brief Sets the display frame period used to estimate the scroll position
+	@param framePeriodUs time of one display frame in microseconds
+	@note The period depends on the oscillator of each panel, measure it for
+		long running tickers. Errors are corrected once per lap.
+*/
+void OLEDTicker::setFramePeriod(uint32_t framePeriodUs)
+{
+	static const uint16_t framesPerStep[8] = {5, 64, 128, 256, 3, 4, 25, 2};
+	_framePeriodUs = framePeriodUs;
+	_stepUs = framePeriodUs * framesPerStep[_interval & 0x07];
+	if (_stepUs == 0) _stepUs = 1;
+}
+
+/*!
+	@brief Writes the columns exposed since the last call, call it often
+	@return number of columns written, 0 when nothing moved
+	@details Normally one column goes through a one column window while the
+		scroll runs. After a full lap of the screen, or if calls were too far
+		apart, the page is rewritten and the scroll restarted instead.
+*/
+uint8_t OLEDTicker::service(void)
+{
+	if (!_running) return 0;
+	uint32_t steps = scrolledSteps();
+	if (steps == _written) return 0;
+	uint32_t owed = steps - _written;
+	if (steps >= _width || owed >= _width)
+	{
+		_oled.OLEDStopScroll();
+		_base += steps;
+		restart();
+		return _width;
+	}
+	// undocumented: display RAM is written while the scroll runs
+	// after the shifts the right edge shows the newest owed columns
+	uint8_t x = _width - owed;
+	_oled.OLEDSetWindow(x, _width - 1, _page, _page);
+	writeColumns(_base + steps + x, owed);
+	_written = steps;
+	return owed;
+}
+
+/*!
+	@brief Copies the current picture of the ticker into the display buffer
+	@note Done at the estimated position, the next OLEDupdate then matches it.
+*/
+void OLEDTicker::syncBuffer(void)
+{
+	if (_pText == nullptr) return;
+	uint32_t first = offset();
+	for (uint8_t x = 0; x < _width; x++)
+		_oled.drawColumnBits(x, _page * 8, textColumn(first + x), 8, WHITE, BLACK);
+}
+
+/*!
+	@brief Gets the text column shown at the left edge
+	@return column count since begin, wraps with the text length
+*/
+uint32_t OLEDTicker::offset(void) const
+{
+	uint32_t steps = _running ? scrolledSteps() : 0;
+	return (_textColumns > 0) ? (_base + steps) % _textColumns : 0;
+}
+
+/*!
+	@brief Estimates the steps scrolled since the last start , used internally
+	@return step count
+*/
+uint32_t OLEDTicker::scrolledSteps(void) const
+{
+	return (uint32_t)((time_us_64() - _startUs) / _stepUs);
+}
+
+/*!
+	@brief Gets one column of the repeating text , used internally
+	@param column text column, any value
+	@return page byte, bit 0 top
+*/
+uint8_t OLEDTicker::textColumn(uint32_t column) const
+{
+	column %= _textColumns;
+	uint32_t cell = column / (_glyphWidth + 1);
+	uint8_t x = column % (_glyphWidth + 1);
+	if (x == _glyphWidth || _pText[cell] == '\0') return 0x00; // padding or gap between laps
+
+	uint8_t index = (uint8_t)_pText[cell] - _fontFirst;
+	if ((uint8_t)_pText[cell] < _fontFirst || index >= _fontCount) return 0x00;
+	return _pFont[index * _glyphWidth + x];
+}
+
+/*!
+	@brief Sends text columns into the current window , used internally
+	@param firstColumn text column of the first byte
+	@param count number of columns
+*/
+void OLEDTicker::writeColumns(uint32_t firstColumn, uint8_t count)
+{
+	uint8_t line[128];
+	if (count > sizeof(line)) count = sizeof(line);
+	for (uint8_t i = 0; i < count; i++)
+		line[i] = textColumn(firstColumn + i);
+	_oled.OLEDWriteData(line, count);
+}
+
+/*!
+	@brief Rewrites the page from the model and starts the scroll , used internally
+*/
+void OLEDTicker::restart(void)
+{
+	_base %= _textColumns;
+	_oled.OLEDSetWindow(0, _width - 1, _page, _page);
+	writeColumns(_base, _width);
+	_oled.OLEDStartScrollLeft(_page, _page, _interval);
+	_startUs = time_us_64();
+	_written = 0;
+	_running = true;
+}
@@ -0,0 +1,67 @@
+/*!
+	@file ssd1306_oled_ticker.h
+	@brief OLED driven by SSD1306 controller. header file
+		for the hardware scrolled text ticker.
+	@details The controller scrolls one page of display RAM left by itself.
+		The ticker works out from the time how many columns have scrolled
+		and writes only the newly exposed column at the right edge through a
+		one column window while the scroll runs, a few bytes per step.
+	@warning The datasheet forbids display RAM access after the scroll
+		activate command (2Fh). The ticker relies on the controller accepting
+		the writes anyway, which it does not document. Check on the panel in
+		use that the picture stays clean.
+*/
+
+#pragma once
+
+#include "ssd1306_oled.h"
+
+#ifndef OLED_TICKER_FOSC_HZ
+#define OLED_TICKER_FOSC_HZ 370000 /**< Typical oscillator frequency at the OLEDinit clock setting */
+#endif
+/*! Display clocks per row at the OLEDinit pre-charge , phase 1 + phase 2 + 50 */
+#define OLED_TICKER_DCLKS_PER_ROW ((SSD1306_PRECHARGE_INIT & 0x0F) + (SSD1306_PRECHARGE_INIT >> 4) + 50)
+
+/*!
+	@brief class for a text ticker scrolled by the controller
+	@note Uses fonts 1-6 at text size 1, screen rotation 0 and one page.
+		While running, the display RAM of the page is owned by the ticker,
+		OLEDupdate would overwrite it. Call syncBuffer to copy the current
+		picture into the buffer.
+*/
+class OLEDTicker
+{
+  public:
+	OLEDTicker(SSD1306 &oled) : _oled(oled) {};
+
+	bool begin(uint8_t page, const char *pText, OLEDScrollInterval_e interval = OLEDScroll_5Frames);
+	void end(void);
+	void setFramePeriod(uint32_t framePeriodUs);
+	uint8_t service(void);
+	void syncBuffer(void);
+	uint32_t offset(void) const;
+
+  private:
+
+	uint32_t scrolledSteps(void) const;
+	uint8_t textColumn(uint32_t column) const;
+	void writeColumns(uint32_t firstColumn, uint8_t count);
+	void restart(void);
+
+	SSD1306 &_oled;                 /**< Display the ticker runs on */
+	const char *_pText = nullptr;   /**< Text, repeats with one blank cell between laps */
+	const uint8_t *_pFont = nullptr; /**< Glyph table of the font at begin */
+	uint8_t _fontFirst = 0;         /**< First character in the glyph table */
+	uint8_t _fontCount = 0;         /**< Characters in the glyph table */
+	uint32_t _textColumns = 0;      /**< Columns in one lap of the text */
+	uint8_t _page = 0;              /**< Display RAM page scrolled */
+	uint8_t _width = 128;           /**< Width of display in pixels */
+	uint8_t _glyphWidth = 5;        /**< Glyph width of font in pixels, without padding */
+	OLEDScrollInterval_e _interval = OLEDScroll_5Frames; /**< Frames per step */
+	uint32_t _framePeriodUs = 0;    /**< Estimated display frame period */
+	uint32_t _stepUs = 0;           /**< Estimated time per scroll step */
+	uint64_t _startUs = 0;          /**< Time the scroll was last started */
+	uint32_t _base = 0;             /**< Text column at the left edge when last started */
+	uint32_t _written = 0;          /**< Steps since start whose new column was written */
+	bool _running = false;          /**< Hardware scroll active */
+};